@@ -0,0 +1,68 @@
+# Command line solver, does not require Qt at runtime
+TEMPLATE = app
+TARGET = burnback-3d-cli
+QT -= core gui
+CONFIG += c++17 console
+CONFIG -= qt app_bundle
+
+CONFIG(sanitizer) {
+	message("Sanitizer enabled")
+	CONFIG += sanitizer sanitize_address sanitize_undefined
+}
+
+
+# vectorized kernels, the binary will only run on processors supporting the instruction set
+CONFIG(avx512) {
+	message("AVX-512 kernels enabled")
+	msvc: QMAKE_CXXFLAGS += /arch:AVX512
+	else: QMAKE_CXXFLAGS += -mavx512f -mavx2 -mfma
+} else: CONFIG(avx2) {
+	message("AVX2 kernels enabled")
+	msvc: QMAKE_CXXFLAGS += /arch:AVX2
+	else: QMAKE_CXXFLAGS += -mavx2 -mfma
+}
+
+
+CONFIG(debug, debug|release) {
+	QMAKE_LINK=clang++
+	QMAKE_CXX = clang++
+	DESTDIR = target/debug
+	DEFINES += DEBUG
+} else {
+	DESTDIR = target/release
+	DEFINES += RELEASE
+}
+
+INCLUDEPATH += include
+
+OBJECTS_DIR = $$DESTDIR/objects-cli
+
+HEADERS += \
+	./src/headers/types.h \
+	./src/headers/activeSet.h \
+	./src/headers/checkpoint.h \
+	./src/headers/globals.h \
+	./src/headers/implicit.h \
+	./src/headers/iosystem.h \
+	./src/headers/operations.h \
+	./src/headers/parallel.h \
+	./src/headers/plotData.h \
+	./src/headers/reorder.h \
+	./src/headers/simd.h \
+	./src/headers/solver.h
+SOURCES += \
+	./src/activeSet.cpp \
+	./src/checkpoint.cpp \
+	./src/cli.cpp \
+	./src/implicit.cpp \
+	./src/iosystem.cpp \
+	./src/operations.cpp \
+	./src/parallel.cpp \
+	./src/plotData.cpp \
+	./src/reorder.cpp \
+	./src/solver.cpp
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
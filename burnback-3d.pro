@@ -1,6 +1,7 @@
 # QT += qml
 QT += quick
 QT += widgets
+QT += 3dcore 3drender
 CONFIG += c++17
 
 CONFIG(sanitizer) {
@@ -9,6 +10,18 @@ CONFIG(sanitizer) {
 }
 
 
+# vectorized kernels, the binary will only run on processors supporting the instruction set
+CONFIG(avx512) {
+	message("AVX-512 kernels enabled")
+	msvc: QMAKE_CXXFLAGS += /arch:AVX512
+	else: QMAKE_CXXFLAGS += -mavx512f -mavx2 -mfma
+} else: CONFIG(avx2) {
+	message("AVX2 kernels enabled")
+	msvc: QMAKE_CXXFLAGS += /arch:AVX2
+	else: QMAKE_CXXFLAGS += -mavx2 -mfma
+}
+
+
 CONFIG(debug, debug|release) {
 	QMAKE_LINK=clang++
 	QMAKE_CXX = clang++
@@ -30,17 +43,32 @@ DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
 
 HEADERS += \
 	./src/headers/types.h \
+	./src/headers/activeSet.h \
+	./src/headers/checkpoint.h \
 	./src/headers/globals.h \
+	./src/headers/implicit.h \
 	./src/headers/iosystem.h \
 	./src/headers/operations.h \
+	./src/headers/parallel.h \
 	./src/headers/interface.h \
-	./src/headers/plotData.h
+	./src/headers/isosurfaceGeometry.h \
+	./src/headers/plotData.h \
+	./src/headers/reorder.h \
+	./src/headers/simd.h \
+	./src/headers/solver.h
 SOURCES += \
+	./src/activeSet.cpp \
+	./src/checkpoint.cpp \
 	./src/main.cpp \
+	./src/implicit.cpp \
 	./src/iosystem.cpp \
 	./src/operations.cpp \
+	./src/parallel.cpp \
 	./src/interface.cpp \
-	./src/plotData.cpp
+	./src/isosurfaceGeometry.cpp \
+	./src/plotData.cpp \
+	./src/reorder.cpp \
+	./src/solver.cpp
 RESOURCES += src-qml/qml.qrc
 
 # Default rules for deployment.
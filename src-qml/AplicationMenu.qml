@@ -39,7 +39,7 @@ MenuBar {
 			selectExisting: false
 			selectFolder: false
 			folder: ""
-			nameFilters: ["JSON file (*.json)", "All files (*)"]
+			nameFilters: ["JSON file (*.json)", "Binary results (*.bbr)", "All files (*)"]
 			onAccepted: actions.exportData(exportDialog.fileUrl, exportDialog.exportPretty)
 		}
 		MenuSeparator {}
@@ -18,7 +18,7 @@ ScrollView {
 
 				Label {
 					id: meshLabel
-					text: qsTr("Click \"import\" and select a mesh file (*.json)")
+					text: qsTr("Click \"import\" and select a mesh file (*.json, *.bbm)")
 					width: parent.width
 					wrapMode: Text.Wrap
 				}
@@ -33,7 +33,7 @@ ScrollView {
 					selectExisting: true
 					selectFolder: false
 					folder: ""
-					nameFilters: ["Mesh files (*.json *.dat)", "All files (*)"]
+					nameFilters: ["Mesh files (*.json *.bbm *.dat)", "All files (*)"]
 					onAccepted: {
 						meshLabel.text = ("Current selection:\n" + basename(fileUrl.toString()))
 						actions.readMesh(fileUrl)
@@ -90,6 +90,89 @@ ScrollView {
 					objName: "targetIter"
 					negative: false
 				}
+
+				LabelInput {
+					text: "Threads"
+					placeholderText: "Enter a number"
+					toolTipText: "Number of threads used for the computation\n\nDefault: 0 (all the available cores)"
+					defaultInput: "0"
+					objName: "threads"
+					negative: false
+				}
+
+				LabelInput {
+					text: "Tolerance"
+					placeholderText: "Enter a number"
+					toolTipText: "The computation stops when the error is below this value (the error shown is multiplied by 100)\n\nDefault: 0 (disabled)"
+					defaultInput: "0"
+					objName: "tolerance"
+					decimals: true
+					negative: false
+				}
+
+				LabelInput {
+					text: "Plateau iterations"
+					placeholderText: "Enter a number"
+					toolTipText: "The computation stops when the error has not improved by 1% in this number of iterations\n\nDefault: 0 (disabled)"
+					defaultInput: "0"
+					objName: "plateau"
+					negative: false
+				}
+
+				LabelInput {
+					text: "Active set threshold"
+					placeholderText: "Enter a number"
+					toolTipText: "Only the nodes whose residual is above this value and their neighbours are updated, the whole mesh is revalidated every 50 iterations\n\nDefault: 0 (disabled)"
+					defaultInput: "0"
+					objName: "activeThreshold"
+					decimals: true
+					negative: false
+				}
+
+				CheckBox {
+					objectName: "adaptiveCfl"
+					text: qsTr("Adaptive CFL")
+					ToolTip.text: qsTr("Grows the CFL while the error decreases, and halves it rolling back to the last good solution when the error spikes")
+					ToolTip.visible: hovered
+					ToolTip.delay: 500
+					hoverEnabled: true
+				}
+
+				CheckBox {
+					objectName: "localTimeStep"
+					text: qsTr("Local time step")
+					ToolTip.text: qsTr("Each node advances with its own stable time step instead of the one of the worst element of the mesh. Only the converged solution is meaningful")
+					ToolTip.visible: hovered
+					ToolTip.delay: 500
+					hoverEnabled: true
+				}
+
+				CheckBox {
+					objectName: "implicit"
+					text: qsTr("Implicit")
+					ToolTip.text: qsTr("Solves the steady state with Newton-Krylov, starting from the CFL above and growing it as the residual drops. Only the converged solution is meaningful")
+					ToolTip.visible: hovered
+					ToolTip.delay: 500
+					hoverEnabled: true
+				}
+
+				CheckBox {
+					objectName: "sweep"
+					text: qsTr("Gauss-Seidel sweep")
+					ToolTip.text: qsTr("Updates the nodes in place in the order of the burn from the inlets, so each node uses the neighbours already updated. Only the converged solution is meaningful")
+					ToolTip.visible: hovered
+					ToolTip.delay: 500
+					hoverEnabled: true
+				}
+
+				CheckBox {
+					objectName: "fastMarching"
+					text: qsTr("Fast marching")
+					ToolTip.text: qsTr("Initializes a new computation with the arrival time from the inlets, so the iterations only refine it")
+					ToolTip.visible: hovered
+					ToolTip.delay: 500
+					hoverEnabled: true
+				}
 			}
 		}
 
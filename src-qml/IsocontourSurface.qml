@@ -7,6 +7,7 @@ import Qt3D.Core 2.0
 import Qt3D.Render 2.5
 import Qt3D.Input 2.0
 import Qt3D.Extras 2.0
+import Burnback 1.0
 
 Item {
 	Connections {
@@ -29,9 +30,6 @@ Item {
 			camera.viewCenter = Qt.vector3d(0, 0, 0)
 			camera.upVector = Qt.vector3d(0, 1, 0)
 		}
-		function onLoadMeshPreview(url) {
-			sceneLoader.source = url
-		}
 	}
 	Scene3D {
 		id: mainScene3d
@@ -100,8 +98,17 @@ Item {
 			]
 			Entity {
 				components: [
-					SceneLoader {
-						id: sceneLoader
+					GeometryRenderer {
+						primitiveType: GeometryRenderer.Triangles
+						geometry: IsosurfaceGeometry {
+							objectName: "isosurfaceGeometry"
+						}
+					},
+					PhongMaterial {
+						ambient: "#333333"
+						diffuse: "#808080"
+						specular: "#808080"
+						shininess: 250
 					}
 				]
 			}
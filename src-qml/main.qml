@@ -11,10 +11,6 @@ ApplicationWindow {
 	visible: true
 	title: qsTr("Burnback 3D")
 
-	onClosing: {
-		actions.clearCache()
-	}
-
 	menuBar: AplicationMenu {}
 
 	contentData: RowLayout {
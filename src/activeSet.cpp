@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <cmath>
+#include <src/headers/activeSet.h>
+#include <src/headers/globals.h>
+#include <src/headers/operations.h>
+
+using namespace std;
+
+namespace ActiveSet {
+namespace {
+// iterations between revalidations of the whole mesh, which catch the nodes that drifted while skipped
+const uint revalidationInterval = 50;
+// the update of a node only reads its neighbours, so a change moves one layer of nodes per iteration
+// and a halo of this many layers around the active nodes lets the set be selected once every haloLayers iterations
+const uint haloLayers = 4;
+// above this fraction of active nodes, the kernels of the whole mesh are faster than the lists
+const double denseFraction = 0.75;
+
+vector<uint> neighbourOffset;
+vector<uint> neighbours;
+vector<uint> nodes;
+vector<uint> tetrahedra;
+// selection in which each node and tetrahedra was last added to the lists, so they do not have to be cleared
+vector<uint> nodeMark;
+vector<uint> tetrahedraMark;
+uint mark = 0;
+uint sinceRevalidation = 0;
+uint sinceSelection = 0;
+bool revalidate = true;
+// the whole mesh is updated until the next revalidation
+bool dense = false;
+
+// nodes of the last update whose residual is above the threshold, with haloLayers of neighbours,
+// and the tetrahedra around them, whose mean gradient they read
+void select(const vector<uint> &updated) {
+	++mark;
+	vector<uint> next;
+	const auto &flux = computationData.flux;
+	for (auto &node : updated) {
+		if (abs(flux[0][node] + input.diffusiveWeight * recession[node] * flux[1][node]) > input.activeThreshold) {
+			nodeMark[node] = mark;
+			next.push_back(node);
+		}
+	}
+	uint begin = 0;
+	for (uint layer = 0; layer < haloLayers; ++layer) {
+		const uint end = next.size();
+		for (auto index = begin; index < end; ++index) {
+			const auto node = next[index];
+			for (auto entry = neighbourOffset[node]; entry < neighbourOffset[node + 1]; ++entry) {
+				const auto &neighbour = neighbours[entry];
+				if (nodeMark[neighbour] != mark) {
+					nodeMark[neighbour] = mark;
+					next.push_back(neighbour);
+				}
+			}
+		}
+		begin = end;
+	}
+	sinceSelection = 0;
+	revalidate = next.empty();
+	dense = next.size() > denseFraction * mesh.nodes.size();
+	if (dense)
+		return;
+
+	vector<uint> around;
+	for (auto &node : next) {
+		for (auto entry = nodeIncidence.offset[node]; entry < nodeIncidence.offset[node + 1]; ++entry) {
+			const auto tetrahedra = nodeIncidence.entries[entry] / 4;
+			if (tetrahedraMark[tetrahedra] != mark) {
+				tetrahedraMark[tetrahedra] = mark;
+				around.push_back(tetrahedra);
+			}
+		}
+	}
+	// in mesh order, for the locality of the kernels
+	sort(next.begin(), next.end());
+	sort(around.begin(), around.end());
+	nodes = move(next);
+	tetrahedra = move(around);
+}
+
+double iterateAll() {
+	Tetrahedra::computeMeanGradient();
+	const auto error = Nodes::computeFused();
+	if (neighbourOffset.size() != mesh.nodes.size() + 1) {
+		Nodes::computeNeighbours(neighbourOffset, neighbours);
+		nodeMark = vector<uint>(mesh.nodes.size(), 0);
+		tetrahedraMark = vector<uint>(mesh.tetrahedra.size(), 0);
+	}
+	vector<uint> all(mesh.nodes.size());
+	for (uint node = 0; node < all.size(); ++node)
+		all[node] = node;
+	select(all);
+	sinceRevalidation = 0;
+	return error;
+}
+}
+
+void reset() {
+	revalidate = true;
+	neighbourOffset.clear();
+}
+
+double iterate() {
+	if (revalidate || ++sinceRevalidation >= revalidationInterval)
+		return iterateAll();
+	if (dense) {
+		Tetrahedra::computeMeanGradient();
+		return Nodes::computeFused();
+	}
+
+	Tetrahedra::computeMeanGradient(tetrahedra);
+	Nodes::computeFused(nodes);
+	// the skipped nodes keep the flux of their last update
+	const auto error = Nodes::getError();
+	if (++sinceSelection >= haloLayers)
+		select(nodes);
+	// the error of the skipped nodes may be outdated, so convergence is only reported after a revalidation
+	if (error < input.tolerance)
+		return iterateAll();
+	return error;
+}
+}
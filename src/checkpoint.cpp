@@ -0,0 +1,154 @@
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <src/headers/checkpoint.h>
+#include <src/headers/globals.h>
+#include <src/headers/iosystem.h>
+#include <src/headers/reorder.h>
+
+using namespace std;
+
+namespace Checkpoint {
+const char magic[8] = {'B', 'B', '3', 'D', 'C', 'H', 'K', 'P'};
+const uint32_t version = 2;
+
+struct Header {
+	char magic[8];
+	uint32_t version;
+	uint32_t iterations;
+	uint64_t nodes;
+	uint64_t tetrahedra;
+	uint64_t hash;
+	double timeStep;
+	double cfl;
+	double timeTotal;
+	uint64_t errors;
+};
+static_assert(sizeof(Header) == 72, "Unexpected padding of the checkpoint header");
+
+struct Snapshot {
+	Header header;
+	vector<double> uVertex;
+	array<vector<double>, 2> flux;
+	vector<array<double, 3>> gradient;
+	vector<double> errors;
+};
+
+// the write in progress, if any
+future<void> pending;
+
+template <typename T>
+void writeValues(ofstream &file, const vector<T> &values) {
+	file.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+}
+
+template <typename T>
+void readValues(ifstream &file, vector<T> &values, uint64_t size) {
+	values.resize(size);
+	file.read(reinterpret_cast<char *>(values.data()), size * sizeof(T));
+}
+
+void write(const string &filepath, const Snapshot &snapshot) {
+	const auto temporary = filepath + ".tmp";
+	{
+		ofstream file(temporary, ios::binary | ios::trunc);
+		file.write(reinterpret_cast<const char *>(&snapshot.header), sizeof(Header));
+		writeValues(file, snapshot.uVertex);
+		writeValues(file, snapshot.flux[0]);
+		writeValues(file, snapshot.flux[1]);
+		writeValues(file, snapshot.gradient);
+		writeValues(file, snapshot.errors);
+		if (!file.good())
+			throw std::invalid_argument("Unable to write checkpoint " + temporary);
+	}
+	// the previous checkpoint is kept until the new one is complete, and replaced without a moment with no checkpoint
+	error_code error;
+	filesystem::rename(temporary, filepath, error);
+	if (error)
+		throw std::invalid_argument("Unable to replace checkpoint " + filepath);
+}
+
+void wait() {
+	if (pending.valid())
+		pending.get();
+}
+
+void save(const std::string &filepath, uint iterations) {
+	wait();
+
+	auto snapshot = Snapshot();
+	auto &header = snapshot.header;
+	memcpy(header.magic, magic, sizeof(magic));
+	header.version = version;
+	header.iterations = iterations;
+	header.nodes = mesh.nodes.size();
+	header.tetrahedra = mesh.tetrahedra.size();
+	header.hash = GeometryCache::meshFileHash();
+	header.timeStep = timeStep;
+	header.cfl = input.cfl;
+	header.timeTotal = timeTotal;
+	header.errors = min<uint64_t>(iterations, errorIter.size());
+
+	snapshot.uVertex = computationData.uVertex;
+	snapshot.flux = computationData.flux;
+	snapshot.gradient = vector<array<double, 3>>(mesh.tetrahedra.size());
+	for (uint tetrahedra = 0; tetrahedra < mesh.tetrahedra.size(); ++tetrahedra)
+		snapshot.gradient[tetrahedra] = computationData.tetrahedraGradient(tetrahedra);
+	snapshot.errors.assign(errorIter.begin(), errorIter.begin() + header.errors);
+
+	// only the copy above stalls the iteration loop, the permutations and the disk are handled in the background
+	pending = async(launch::async, [filepath, snapshot = move(snapshot)]() mutable {
+		for (auto *values : {&snapshot.uVertex, &snapshot.flux[0], &snapshot.flux[1]})
+			*values = Reorder::toOriginal(*values, nodePermutation);
+		snapshot.gradient = Reorder::toOriginal(snapshot.gradient, tetrahedraPermutation);
+		write(filepath, snapshot);
+	});
+}
+
+void load(const std::string &filepath) {
+	ifstream file(filepath, ios::binary);
+	if (!file.good())
+		throw std::invalid_argument("Unable to open checkpoint " + filepath);
+
+	Header header;
+	if (!file.read(reinterpret_cast<char *>(&header), sizeof(Header)) || memcmp(header.magic, magic, sizeof(magic)) != 0)
+		throw std::invalid_argument(filepath + " is not a checkpoint file");
+	if (header.version != version)
+		throw std::invalid_argument("Unsupported checkpoint version " + to_string(header.version));
+	if (header.nodes != mesh.nodes.size() || header.tetrahedra != mesh.tetrahedra.size() || header.hash != GeometryCache::meshFileHash())
+		throw std::invalid_argument("The checkpoint " + filepath + " does not belong to this mesh");
+
+	vector<double> uVertex;
+	array<vector<double>, 2> flux;
+	vector<array<double, 3>> gradient;
+	vector<double> errors;
+	readValues(file, uVertex, header.nodes);
+	readValues(file, flux[0], header.nodes);
+	readValues(file, flux[1], header.nodes);
+	readValues(file, gradient, header.tetrahedra);
+	readValues(file, errors, header.errors);
+	if (!file)
+		throw std::invalid_argument("The checkpoint " + filepath + " is incomplete");
+
+	computationData = ComputationData(mesh.nodes.size(), mesh.tetrahedra.size());
+	computationData.uVertex = Reorder::fromOriginal(uVertex, nodePermutation);
+	for (uint index = 0; index < 2; ++index)
+		computationData.flux[index] = Reorder::fromOriginal(flux[index], nodePermutation);
+	gradient = Reorder::fromOriginal(gradient, tetrahedraPermutation);
+	for (uint tetrahedra = 0; tetrahedra < mesh.tetrahedra.size(); ++tetrahedra) {
+		for (uint component = 0; component < 3; ++component)
+			computationData.gradient[component][tetrahedra] = gradient[tetrahedra][component];
+	}
+
+	currentIter = header.iterations;
+	timeStep = header.timeStep;
+	input.cfl = header.cfl;
+	timeTotal = header.timeTotal;
+	errorIter = move(errors);
+	input.resume = true;
+	input.restart = true;
+}
+}
@@ -0,0 +1,401 @@
+#ifdef _WIN32
+#define _USE_MATH_DEFINES
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <src/headers/checkpoint.h>
+#include <src/headers/globals.h>
+#include <src/headers/iosystem.h>
+#include <src/headers/reorder.h>
+#include <src/headers/solver.h>
+
+#ifdef DEBUG
+#include <fenv.h>
+#endif
+
+using namespace std;
+
+void printHelp() {
+	cout << R"(
+Usage: burnback-3d-cli [options] mesh.json|mesh.bbm
+       burnback-3d-cli convert [-o output.bbm] mesh.json
+Converts a JSON mesh to the binary mesh format, which is read without parsing
+Options:
+	-o, --output <file>: Output file name, defaults to the mesh file name with the -results.json suffix
+		files with the .bbr extension are written as binary results, without the mesh
+	-p, --pretty: Using pretty output
+	-i, --iterations <number>: Target iterations, defaults to 300
+	-c, --cfl <number>: CFL number, defaults to 1
+	--tolerance <number>: Stops when the error is below the value (the printed error is multiplied by 100), defaults to 0
+	--plateau <number>: Stops when the error has not improved by 1% in the number of iterations, defaults to 0 (disabled)
+	--adaptive-cfl: Grows the CFL while the error decreases, and halves it rolling back to the last good solution when the error spikes
+	-w, --diffusive-weight <number>: Weight of the diffusive flux, defaults to 1
+	-t, --threads <number>: Number of threads used by the iteration loop, defaults to all the available cores
+	--recompute-gradient: Computes the mean gradient from the coordinates every iteration instead of using the stored gradient operator
+	--no-geometry-cache: Does not read or write the geometry cache (mesh file name with the .geom extension, or .reordered.geom with --reorder)
+	--reorder: Renumbers the nodes and tetrahedra for memory locality, the results keep the numbering of the mesh file
+	--active-set <number>: Only updates the nodes whose residual is above the value and their neighbours, revalidating the whole mesh every 50 iterations, defaults to 0 (disabled)
+	--sweep: Updates the nodes in place with a Gauss-Seidel sweep in the order of the burn from the inlets, instead of from the previous iteration
+	--implicit: Solves the steady state with Newton-Krylov and a growing pseudo time step instead of the explicit time marching, the CFL is the initial one
+	--fast-marching: Initializes the solution with the arrival time from the inlets computed by fast marching, instead of the initial value
+	--local-time-step: Advances each node with its own stable time step, from its tetrahedra and recession, instead of the global one
+	--unfused: Runs each step of the iteration as a separate sweep instead of the fused node sweep
+	--scatter: Computes the vertex gradient and diffusive flux by tetrahedra (colored when multithreaded) instead of by nodes, implies --unfused
+	-b, --boundary <tag>:<type>[:<value>]: Overrides a boundary of the mesh file
+		type is one of inlet, outlet or symmetry
+		value is the initial time for inlets and the normal vector (x,y,z) for symmetries
+	-r, --recession <file>: Reads the recession of each node from a text file
+		one line per node, with 1 number (isotropic) or 3/6 numbers (anisotropic)
+	--checkpoint <file>: Periodically saves the state of the iteration loop to a binary checkpoint, and at the end
+	--checkpoint-interval <seconds>: Time between checkpoints, defaults to 600
+	--restart <file>: Continues from a checkpoint of the same mesh until the target iterations, skipping the initialization
+	-q, --quiet: Only print errors
+	-h, --help: Show this help
+)";
+}
+
+vector<double> splitNumbers(const string &text, char separator) {
+	vector<double> numbers;
+	stringstream stream(text);
+	string item;
+	while (getline(stream, item, separator)) {
+		if (item.empty())
+			continue;
+		numbers.push_back(stod(item));
+	}
+	return numbers;
+}
+
+void overrideBoundary(const string &argument) {
+	auto firstSeparator = argument.find(':');
+	if (firstSeparator == string::npos)
+		throw invalid_argument("Wrong boundary format: " + argument);
+
+	auto secondSeparator = argument.find(':', firstSeparator + 1);
+	uint tag = stoul(argument.substr(0, firstSeparator));
+	auto type = argument.substr(firstSeparator + 1, secondSeparator - firstSeparator - 1);
+	auto value = secondSeparator == string::npos ? "" : argument.substr(secondSeparator + 1);
+
+	if (boundaries.find(tag) == boundaries.end() || tag == 0)
+		throw invalid_argument("Boundary " + to_string(tag) + " does not exist in the mesh");
+
+	auto &boundary = boundaries[tag];
+	const vector<string> boundaryTypes = {"inlet", "outlet", "symmetry"};
+	auto typeIndex = find(boundaryTypes.begin(), boundaryTypes.end(), type) - boundaryTypes.begin();
+	if (typeIndex == (long)boundaryTypes.size())
+		throw invalid_argument("Unknown boundary type: " + type);
+	boundary.type = typeIndex + 1;
+
+	auto values = splitNumbers(value, ',');
+	switch (boundary.type) {
+		case INLET:
+			boundary.value = {values.empty() ? 0 : values[0], 0, 0};
+			break;
+		case SYMMETRY:
+			if (values.size() != 3)
+				throw invalid_argument("Symmetry boundaries require a normal vector (x,y,z)");
+			boundary.value = {values[0], values[1], values[2]};
+			break;
+		default:
+			boundary.value = {0, 0, 0};
+			break;
+	}
+}
+
+void readRecessions(const string &filepath) {
+	ifstream file(filepath);
+	if (!file.good())
+		throw invalid_argument("Unable to open recession file " + filepath);
+
+	vector<vector<double>> lines;
+	string line;
+	while (getline(file, line)) {
+		auto values = splitNumbers(line, ' ');
+		if (values.empty())
+			continue;
+		lines.push_back(values);
+	}
+	if (lines.size() != mesh.nodes.size())
+		throw invalid_argument("Recession file has " + to_string(lines.size()) + " lines, expected " + to_string(mesh.nodes.size()));
+
+	if (lines[0].size() == 1) {
+		recession = vector<double>(mesh.nodes.size());
+		anisotropic = false;
+		recessionAnisotropic.clear();
+		recessionMatrix.clear();
+		for (uint node = 0; node < mesh.nodes.size(); ++node)
+			recession[node] = lines[Reorder::originalNode(node)][0];
+		return;
+	}
+
+	recession = vector<double>(mesh.nodes.size());
+	recessionAnisotropic = vector<array<double, 6>>(mesh.nodes.size());
+	anisotropic = true;
+	for (uint node = 0; node < mesh.nodes.size(); ++node) {
+		auto &values = lines[Reorder::originalNode(node)];
+		if (values.size() != 3 && values.size() != 6)
+			throw invalid_argument("Wrong recession format in line " + to_string(Reorder::originalNode(node) + 1));
+		for (uint i = 0; i < values.size(); ++i)
+			recessionAnisotropic[node][i] = values[i];
+	}
+}
+
+void readMesh(string &filepath) {
+	if (Binary::isBinary(filepath))
+		Binary::readMesh(filepath);
+	else
+		Json::readMesh(filepath);
+}
+
+int convert(int argc, char *argv[]) {
+	string meshPath = "";
+	string outputPath = "";
+	for (int index = 2; index < argc; ++index) {
+		string argument = argv[index];
+		if ((argument == "-o" || argument == "--output") && index + 1 < argc) {
+			outputPath = argv[++index];
+		} else if (argument[0] == '-') {
+			cerr << "Error: Unknown option " << argument << ". Use -h or --help for help" << endl;
+			return 1;
+		} else {
+			meshPath = argument;
+		}
+	}
+	if (meshPath == "") {
+		cerr << "No input file specified. Use -h or --help for help" << endl;
+		return 1;
+	}
+	if (outputPath == "")
+		outputPath = meshPath.substr(0, meshPath.rfind('.')) + Binary::extension;
+
+	try {
+		readMesh(meshPath);
+		Binary::writeMesh(outputPath);
+	} catch (std::exception &e) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
+	}
+	cout << "Converted " << meshPath << " to " << outputPath << endl;
+	return 0;
+}
+
+int main(int argc, char *argv[]) {
+#ifdef DEBUG
+	feenableexcept(FE_DIVBYZERO | FE_INVALID | FE_OVERFLOW);
+#endif
+	if (argc > 1 && string(argv[1]) == "convert")
+		return convert(argc, argv);
+	string meshPath = "";
+	string outputPath = "";
+	string recessionPath = "";
+	string checkpointPath = "";
+	string restartPath = "";
+	double checkpointInterval = 600;
+	vector<string> boundaryOverrides;
+	bool pretty = false;
+	bool quiet = false;
+	bool geometryCache = true;
+
+	input.uInitial = 0;
+	input.resume = false;
+	input.cfl = 1;
+	input.targetIter = 300;
+	input.diffusiveWeight = 1;
+	input.threads = 0;
+	input.gather = true;
+	input.fused = true;
+	input.storedGradient = true;
+	input.reorder = false;
+	input.localTimeStep = false;
+	input.fastMarching = false;
+	input.implicit = false;
+	input.sweep = false;
+	input.activeThreshold = 0;
+	input.tolerance = 0;
+	input.plateau = 0;
+	input.adaptiveCfl = false;
+
+	try {
+		for (int index = 1; index < argc; ++index) {
+			string argument = argv[index];
+			auto next = [&]() {
+				if (index + 1 >= argc)
+					throw invalid_argument("Missing value for " + argument);
+				return string(argv[++index]);
+			};
+
+			if (argument == "-h" || argument == "--help") {
+				printHelp();
+				return 0;
+			} else if (argument == "-o" || argument == "--output") {
+				outputPath = next();
+			} else if (argument == "-p" || argument == "--pretty") {
+				pretty = true;
+			} else if (argument == "-i" || argument == "--iterations") {
+				input.targetIter = stoul(next());
+			} else if (argument == "-c" || argument == "--cfl") {
+				input.cfl = stod(next());
+			} else if (argument == "--tolerance") {
+				input.tolerance = stod(next());
+			} else if (argument == "--plateau") {
+				input.plateau = stoul(next());
+			} else if (argument == "--adaptive-cfl") {
+				input.adaptiveCfl = true;
+			} else if (argument == "-w" || argument == "--diffusive-weight") {
+				input.diffusiveWeight = stod(next());
+			} else if (argument == "-t" || argument == "--threads") {
+				input.threads = stoul(next());
+			} else if (argument == "--recompute-gradient") {
+				input.storedGradient = false;
+			} else if (argument == "--no-geometry-cache") {
+				geometryCache = false;
+			} else if (argument == "--reorder") {
+				input.reorder = true;
+			} else if (argument == "--active-set") {
+				input.activeThreshold = stod(next());
+			} else if (argument == "--implicit") {
+				input.implicit = true;
+			} else if (argument == "--sweep") {
+				input.sweep = true;
+			} else if (argument == "--fast-marching") {
+				input.fastMarching = true;
+			} else if (argument == "--local-time-step") {
+				input.localTimeStep = true;
+			} else if (argument == "--unfused") {
+				input.fused = false;
+			} else if (argument == "--scatter") {
+				input.gather = false;
+			} else if (argument == "-b" || argument == "--boundary") {
+				boundaryOverrides.push_back(next());
+			} else if (argument == "-r" || argument == "--recession") {
+				recessionPath = next();
+			} else if (argument == "--checkpoint") {
+				checkpointPath = next();
+			} else if (argument == "--checkpoint-interval") {
+				checkpointInterval = stod(next());
+			} else if (argument == "--restart") {
+				restartPath = next();
+			} else if (argument == "-q" || argument == "--quiet") {
+				quiet = true;
+			} else if (argument[0] == '-') {
+				throw invalid_argument("Unknown option " + argument + ". Use -h or --help for help");
+			} else {
+				meshPath = argument;
+			}
+		}
+	} catch (std::invalid_argument &e) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
+	} catch (std::out_of_range &e) {
+		cerr << "Error: Number out of range" << endl;
+		return 1;
+	}
+
+	if (meshPath == "") {
+		cerr << "No input file specified. Use -h or --help for help" << endl;
+		return 1;
+	}
+	if (outputPath == "")
+		outputPath = meshPath.substr(0, meshPath.rfind('.')) + "-results.json";
+	if (input.targetIter == 0)
+		input.targetIter = 300;
+	input.geometryCache = geometryCache ? GeometryCache::path(meshPath, input.reorder) : "";
+
+	auto log = [&](string text) {
+		if (!quiet)
+			cout << text << "\n";
+	};
+
+	try {
+		log("--> Reading mesh");
+		readMesh(meshPath);
+		for (auto &boundary : boundaryOverrides)
+			overrideBoundary(boundary);
+		if (recessionPath != "")
+			readRecessions(recessionPath);
+		if (restartPath != "") {
+			const auto requestedCfl = input.cfl;
+			Checkpoint::load(restartPath);
+			log("--> Restarting from " + restartPath + " at iteration " + to_string(currentIter));
+			if (input.cfl != requestedCfl)
+				log("--> Using the CFL of the checkpoint, " + to_string(input.cfl) + ", instead of " + to_string(requestedCfl));
+		}
+
+		Solver::setup(log);
+	} catch (std::exception &e) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
+	}
+
+	auto saveCheckpoint = [&](uint iterations) {
+		try {
+			Checkpoint::save(checkpointPath, iterations);
+		} catch (std::exception &e) {
+			cerr << "Warning: " << e.what() << endl;
+		}
+	};
+
+	log("--> Starting subiteration loop");
+	auto clock = chrono::steady_clock::now();
+	auto checkpointClock = clock;
+	for (; currentIter < input.targetIter; ++currentIter) {
+		auto error = Solver::iterate();
+		errorIter[currentIter] = error;
+
+		auto status = Solver::control(error, log);
+		if (status == Solver::DIVERGED) {
+			cerr << "Error: Divergence detected at iteration " << currentIter + 1 << ". Try reducing the CFL." << endl;
+			return 2;
+		}
+		if (status != Solver::RUNNING) {
+			log("Iteration: " + to_string(currentIter + 1) + " Time: " + to_string(timeTotal) + " Error: " + to_string(error * 100) + "%");
+			log(status == Solver::CONVERGED ? "--> Converged below the tolerance" : "--> Error stalled");
+			errorIter.resize(++currentIter);
+			break;
+		}
+
+		auto now = chrono::steady_clock::now();
+		if (checkpointPath != "" && currentIter + 1 < input.targetIter &&
+		    chrono::duration<double>(now - checkpointClock).count() >= checkpointInterval) {
+			checkpointClock = now;
+			saveCheckpoint(currentIter + 1);
+		}
+		if (currentIter + 1 == input.targetIter || chrono::duration_cast<chrono::seconds>(now - clock).count() >= 1) {
+			clock = now;
+			log("Iteration: " + to_string(currentIter + 1) + " Time: " + to_string(timeTotal) + " Error: " + to_string(error * 100) + "%");
+		}
+	}
+	log("--> Subiteration ended");
+
+	if (checkpointPath != "") {
+		log("--> Saving checkpoint to " + checkpointPath);
+		saveCheckpoint(currentIter);
+		try {
+			Checkpoint::wait();
+		} catch (std::exception &e) {
+			cerr << "Warning: " << e.what() << endl;
+		}
+	}
+
+	log("--> Exporting data to " + outputPath);
+	try {
+		if (Binary::isResults(outputPath))
+			Binary::writeResults(outputPath);
+		else
+			Json::writeData(outputPath, meshPath, pretty);
+	} catch (std::exception &e) {
+		cerr << "Error while exporting data: " << e.what() << endl;
+		return 1;
+	}
+	cout << flush;
+
+	return 0;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <src/headers/types.h>
+
+// Narrow band of the fused iteration: only the nodes whose update residual is above input.activeThreshold,
+// with the neighbours they change, are updated, and only the tetrahedra around them get a new mean gradient.
+// The other nodes keep their solution and fluxes, and the whole mesh is revalidated periodically
+namespace ActiveSet {
+// the next iteration revalidates the whole mesh, needed whenever uVertex is changed outside of the iteration
+void reset();
+// performs a single iteration on the active nodes and returns the error of the whole mesh
+double iterate();
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <src/headers/types.h>
+
+// Periodic snapshot of the iteration loop, so long runs can be restarted from disk.
+// The state is copied and written in a background thread, through a temporary file that replaces the checkpoint
+// once complete. The file holds a 72 bytes header (magic, version, iterations, number of nodes and tetrahedra,
+// hash of the mesh, timeStep, CFL, timeTotal and number of errors) followed by the raw doubles of
+// uVertex, Hamiltonian flux and diffusive flux (1 per node), gradient (3 per tetrahedra) and the error of each iteration,
+// in the numbering of the mesh file
+namespace Checkpoint {
+// saves the state after the given number of iterations, waiting for the previous checkpoint to be written
+// throws if the previous checkpoint failed
+void save(const std::string &filepath, uint iterations);
+// waits until the last checkpoint is written, throws if it failed
+void wait();
+// restores the state of the iteration loop, the mesh must be the one of the checkpoint
+// the computation is then resumed, which skips the initialization of the results, with the time step and CFL of the checkpoint
+void load(const std::string &filepath);
+}
@@ -1,8 +1,7 @@
 #pragma once
 
-#include <QQmlApplicationEngine>
-#include <QString>
 #include <array>
+#include <cstdint>
 #include <map>
 #include <src/headers/types.h>
 #include <vector>
@@ -15,28 +14,38 @@ enum {
 	OUTLET_SYMMETRY = 23
 };
 
-inline QObject *root;
-inline QString tmpDir;
-
 inline Input input;
 inline Mesh mesh;
 inline TetrahedraGeometry tetrahedraGeometry;
 inline std::vector<double> angleTotal;
+// smallest height of the tetrahedra of each node, divided by 6 like maxHeight
+inline std::vector<double> nodeHeight;
 inline std::map<uint, Boundary> boundaries;
+inline std::vector<uint> triangleConditions;
 inline std::vector<std::vector<uint>> nodeConditions;
 inline std::vector<uint> boundaryConditions;
 inline std::map<uint, std::vector<std::array<double, 3>>> symmetryConditions;
 inline ComputationData computationData;
+inline std::vector<std::vector<uint>> tetrahedraColors;
+inline NodeIncidence nodeIncidence;
+// nodes of each color of the Gauss-Seidel sweep, in sweep order, built by the solver setup when the sweep is enabled
+inline std::vector<std::vector<uint>> sweepColors;
+inline IsosurfaceIndex isosurfaceIndex;
+// original index of each node and tetrahedra when the mesh is reordered, empty otherwise
+inline std::vector<uint> nodePermutation;
+inline std::vector<uint> tetrahedraPermutation;
 inline double maxHeight;
+// hash of the mesh the current geometry was computed for, 0 when there is no geometry
+inline uint64_t geometryHash = 0;
 
 inline double timeStep;
+// time step of each node when local time stepping is enabled, empty otherwise
+inline std::vector<double> nodeTimeStep;
 inline double timeTotal;
 
 inline uint currentIter = 0;
 inline bool running = false;
 
-inline uint drawCount = 0;
-
 inline std::vector<double> recession;
 inline std::array<std::vector<double>, 2> burningArea;
 inline std::vector<double> errorIter;
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <src/headers/types.h>
+
+// Implicit solver of the steady state R(u) = flux[0] + diffusiveWeight * recession * flux[1] = 0.
+// Each iteration is a Newton step of the backward Euler pseudo transient continuation,
+// (1 / localStep - J) du = R(u), with the CFL of the local steps growing as the residual drops, so it ends as Newton's method.
+// The system is solved with restarted GMRES, where J times a vector is a finite difference of the residual,
+// right preconditioned with the linearized upwind slope along the tetrahedra edges
+namespace Implicit {
+// allocates the solver and resets it, needs the geometry and the boundary conditions
+void setup();
+// resets the pseudo transient continuation to the input CFL, needed whenever uVertex is changed outside of the iteration
+void reset();
+// updates uVertex with a Newton step and returns the error of the solution before it
+double iterate();
+}
@@ -4,6 +4,10 @@
 #include <QString>
 #include <QVariant>
 
+inline QObject *root;
+
+void readInput();
+
 class Actions : public QObject {
 	Q_OBJECT
 	public:
@@ -15,7 +19,6 @@ class Actions : public QObject {
 	void finished();
 	void readFinished(bool success);
 	void setCameraPosition(double x, double y, double z);
-	void loadMeshPreview(QString);
 	void setCulling(uint method);
 	void graphBurningArea(std::vector<double> depth, std::vector<double> area, double xMax, double yMax);
 	void graphErrorIter(std::vector<uint> iteration, std::vector<double> error, uint xMax, double yMax);
@@ -32,7 +35,6 @@ public slots:
 	void afterWorker();
 	void previewIsosurface(double value);
 	void updateIsosurface(double value);
-	void clearCache();
 	void setCullingMethod(uint method);
 	void exportData(QString filepath, bool pretty);
 	std::vector<QString> getBoundaries();
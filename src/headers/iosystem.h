@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <src/headers/types.h>
 
-void readInput();
+namespace Conditions {
+void setNodeConditions();
+}
 
 namespace Json {
 void readMesh(std::string &filepath);
@@ -11,8 +15,41 @@ void updateBoundaries(std::string &filepath, bool &pretty);
 void updateRecessions(std::string &filepath, bool &pretty);
 }
 
-namespace WriteMesh {
-void IsocontourSurface(double value, std::string filepath);
-void Boundary();
-void Material();
+// Versioned binary mesh container (.bbm), little-endian, meant to be memory mapped:
+// a 64 bytes header followed by flat arrays, each starting at a multiple of 8 bytes
+//   nodes: 3 doubles per node
+//   triangles: 3 uint32 per triangle, tetrahedra: 4 uint32 per tetrahedra (1 based node indices)
+//   triangle conditions: 1 uint32 (boundary tag) per triangle
+//   boundaries: tag, type (uint32), value (3 doubles), description offset and size (uint64)
+//   recessions: 1 (isotropic) or 6 (anisotropic) doubles per node
+//   descriptions: characters of the boundary descriptions
+namespace Binary {
+inline const std::string extension = ".bbm";
+bool isBinary(const std::string &filepath);
+void readMesh(std::string &filepath);
+// always written in the numbering of the original mesh, even when it has been reordered
+void writeMesh(std::string &filepath);
+
+// Binary results (.bbr), little-endian, in the numbering of the original mesh:
+// a 56 bytes header (magic, version, iterations, number of nodes and tetrahedra, hash of the original mesh,
+// timeStep and timeTotal as doubles) followed by the raw doubles of
+//   uVertex, Hamiltonian flux and diffusive flux: 1 per node
+//   duVertex: 3 per tetrahedra
+inline const std::string resultsExtension = ".bbr";
+bool isResults(const std::string &filepath);
+void writeResults(std::string &filepath);
+}
+
+// Geometry of the tetrahedra saved next to the mesh, so runs of the same mesh skip computing it.
+// The file is only used when the hash of the nodes and tetrahedra matches
+namespace GeometryCache {
+uint64_t meshHash(const std::vector<std::array<double, 3>> &nodes, const std::vector<std::array<uint, 4>> &tetrahedra);
+uint64_t meshHash();
+// hash of the mesh in the numbering of the mesh file, stored in the results and checkpoints
+uint64_t meshFileHash();
+// path of the cache file of a mesh file, with the .geom extension, or .reordered.geom for the reordered mesh,
+// whose geometry is stored in the new numbering
+std::string path(const std::string &meshPath, bool reordered);
+bool read(const std::string &filepath, uint64_t hash);
+void write(const std::string &filepath, uint64_t hash);
 }
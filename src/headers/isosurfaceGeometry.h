@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QtGlobal>
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+#include <Qt3DRender/QAttribute>
+#include <Qt3DRender/QBuffer>
+#include <Qt3DRender/QGeometry>
+namespace Qt3DGeometry = Qt3DRender;
+#else
+#include <Qt3DCore/QAttribute>
+#include <Qt3DCore/QBuffer>
+#include <Qt3DCore/QGeometry>
+namespace Qt3DGeometry = Qt3DCore;
+#endif
+
+#include <src/headers/types.h>
+
+// Geometry of the isosurface preview, registered in QML as Burnback.IsosurfaceGeometry.
+// The surface is copied directly to the vertex and index buffers, which are kept between values
+class IsosurfaceGeometry : public Qt3DGeometry::QGeometry {
+	Q_OBJECT
+	public:
+	explicit IsosurfaceGeometry(Qt3DCore::QNode *parent = nullptr);
+	void setSurface(const IsocontourData &data);
+
+	private:
+	Qt3DGeometry::QBuffer *vertexBuffer;
+	Qt3DGeometry::QBuffer *indexBuffer;
+	Qt3DGeometry::QAttribute *positionAttribute;
+	Qt3DGeometry::QAttribute *normalAttribute;
+	Qt3DGeometry::QAttribute *indexAttribute;
+};
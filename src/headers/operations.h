@@ -94,22 +94,48 @@ void computeGeometry();
 }
 
 namespace Tetrahedra {
+void computeColoring();
 void computeMeanGradient();
+// only the given tetrahedra
+void computeMeanGradient(const std::vector<uint> &tetrahedra);
 void computeVertexGradient();
+void computeDiffusiveContribution();
 void computeDiffusiveFlux();
 }
 
 
 namespace Nodes {
+void computeIncidence();
+// nodes sharing a tetrahedra with each node, sorted, in [offset[node], offset[node + 1]) of neighbours
+void computeNeighbours(std::vector<uint> &offset, std::vector<uint> &neighbours);
+void computeVertexGradient();
+void computeDiffusiveFlux();
 void computeHamitonianFlux();
 void computeResults();
+double computeFused();
+// only updates the given nodes, without the error
+void computeFused(const std::vector<uint> &nodes);
+// colors of the Gauss-Seidel sweep along the burn, in sweepColors
+void computeSweepColors();
+// a Gauss-Seidel iteration, each node is updated with the nodes before it in the sweep already updated
+double computeSweep();
+double nodeRecession(uint node);
+void computeLocalTimeStep();
 double getMaxRecession();
+std::array<double, 3> symmetryProjection(const std::vector<std::array<double, 3>> &symmetryVector, const std::array<double, 3> &vertexGradient);
 void applySymmetry();
 void setBoundaryConditions();
 double getError();
 }
 
+// arrival time of the burning surface from the inlets, |gradient u| = 1 / recession,
+// used as the initial solution so the time marching only refines it
+namespace Eikonal {
+void fastMarching();
+}
+
 namespace Anisotropic {
 void computeMatrix();
+double effectiveRecession(uint node, const std::array<double, 3> &vertexGradient);
 void computeRecession();
 }
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <functional>
+#include <src/headers/types.h>
+
+// Persistent pool of worker threads used by the iteration kernels
+namespace Parallel {
+// 0 uses all the available cores
+void setThreads(uint threads);
+uint threads();
+// splits [0, size) in contiguous chunks, one per thread, and waits until all of them are done
+// with a single thread the function is called directly with the whole range
+// calls from different threads are run one after the other, calls from inside the function are not allowed
+// prepare is called first with the number of threads the range is split into, to size per thread buffers
+void forRange(uint size, const std::function<void(uint begin, uint end, uint thread)> &function, const std::function<void(uint threads)> &prepare = nullptr);
+}
@@ -3,5 +3,8 @@
 #include <array>
 #include <src/headers/types.h>
 
+// on the interface thread only, the isosurface queries read the index without a lock
+void buildIsosurfaceIndex();
+std::vector<uint> isosurfaceTetrahedra(double value);
 IsocontourData isosurfaceData(double value);
 std::array<std::vector<double>, 2> burnAreaData(uint numberOfAreas);
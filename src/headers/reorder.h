@@ -0,0 +1,46 @@
+#pragma once
+
+#include <src/headers/globals.h>
+
+// Renumbering of the nodes along a space filling curve and of the tetrahedra to match,
+// so the kernels access neighbouring memory. The computation uses the new numbering,
+// the permutations map it back to the numbering of the mesh file for the exported data
+namespace Reorder {
+void reorderMesh();
+
+inline uint originalNode(uint node) {
+	return nodePermutation.empty() ? node : nodePermutation[node];
+}
+
+// values indexed by the new numbering, returned in the numbering of the mesh file
+template <typename T>
+std::vector<T> toOriginal(const std::vector<T> &values, const std::vector<uint> &permutation) {
+	if (permutation.empty())
+		return values;
+	auto original = std::vector<T>(values.size());
+	for (uint index = 0; index < permutation.size(); ++index)
+		original[permutation[index]] = values[index];
+	return original;
+}
+
+// values indexed by the numbering of the mesh file, returned in the new numbering
+template <typename T>
+std::vector<T> fromOriginal(const std::vector<T> &values, const std::vector<uint> &permutation) {
+	if (permutation.empty())
+		return values;
+	auto reordered = std::vector<T>(values.size());
+	for (uint index = 0; index < permutation.size(); ++index)
+		reordered[index] = values[permutation[index]];
+	return reordered;
+}
+
+// elements with the 1 based node indices of the mesh file
+template <typename T>
+std::vector<T> originalNodes(std::vector<T> elements) {
+	for (auto &element : elements) {
+		for (auto &node : element)
+			node = originalNode(node - 1) + 1;
+	}
+	return elements;
+}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#include <src/headers/types.h>
+
+// Thin wrapper over the widest available SIMD registers, so the vectorized kernels are written once
+// for AVX-512 (8 doubles) and AVX2 (4 doubles). Enable them with CONFIG+=avx2 or CONFIG+=avx512
+#if defined(__AVX512F__)
+#define SIMD_ENABLED
+namespace Simd {
+constexpr uint width = 8;
+struct Pack {
+	__m512d value;
+};
+typedef __m256i Index;
+
+inline Pack load(const double *address) { return {_mm512_loadu_pd(address)}; }
+inline void store(double *address, const Pack &pack) { _mm512_storeu_pd(address, pack.value); }
+inline Pack broadcast(double value) { return {_mm512_set1_pd(value)}; }
+// the masked gather with a zeroed source, the plain one leaves the source uninitialized and GCC warns about it
+inline Pack gather(const double *base, const Index &index) {
+	return {_mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xff, index, base, 8)};
+}
+// 0 based index of the given vertex for consecutive tetrahedra, multiplied by scale
+inline Index nodeIndex(const std::array<uint, 4> *tetrahedra, uint vertex, int scale) {
+	const auto stride = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+	const auto nodes = _mm256_i32gather_epi32(reinterpret_cast<const int *>(&tetrahedra[0][vertex]), stride, 4);
+	return _mm256_mullo_epi32(_mm256_sub_epi32(nodes, _mm256_set1_epi32(1)), _mm256_set1_epi32(scale));
+}
+inline Pack operator+(const Pack &a, const Pack &b) { return {_mm512_add_pd(a.value, b.value)}; }
+inline Pack operator-(const Pack &a, const Pack &b) { return {_mm512_sub_pd(a.value, b.value)}; }
+inline Pack operator*(const Pack &a, const Pack &b) { return {_mm512_mul_pd(a.value, b.value)}; }
+inline Pack operator/(const Pack &a, const Pack &b) { return {_mm512_div_pd(a.value, b.value)}; }
+}
+#elif defined(__AVX2__)
+#define SIMD_ENABLED
+namespace Simd {
+constexpr uint width = 4;
+struct Pack {
+	__m256d value;
+};
+typedef __m128i Index;
+
+inline Pack load(const double *address) { return {_mm256_loadu_pd(address)}; }
+inline void store(double *address, const Pack &pack) { _mm256_storeu_pd(address, pack.value); }
+inline Pack broadcast(double value) { return {_mm256_set1_pd(value)}; }
+// the masked gather with a zeroed source, the plain one leaves the source uninitialized and GCC warns about it
+inline Pack gather(const double *base, const Index &index) {
+	const auto all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+	return {_mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, index, all, 8)};
+}
+// 0 based index of the given vertex for consecutive tetrahedra, multiplied by scale
+inline Index nodeIndex(const std::array<uint, 4> *tetrahedra, uint vertex, int scale) {
+	const auto stride = _mm_setr_epi32(0, 4, 8, 12);
+	const auto nodes = _mm_i32gather_epi32(reinterpret_cast<const int *>(&tetrahedra[0][vertex]), stride, 4);
+	return _mm_mullo_epi32(_mm_sub_epi32(nodes, _mm_set1_epi32(1)), _mm_set1_epi32(scale));
+}
+inline Pack operator+(const Pack &a, const Pack &b) { return {_mm256_add_pd(a.value, b.value)}; }
+inline Pack operator-(const Pack &a, const Pack &b) { return {_mm256_sub_pd(a.value, b.value)}; }
+inline Pack operator*(const Pack &a, const Pack &b) { return {_mm256_mul_pd(a.value, b.value)}; }
+inline Pack operator/(const Pack &a, const Pack &b) { return {_mm256_div_pd(a.value, b.value)}; }
+}
+#endif
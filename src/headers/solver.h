@@ -0,0 +1,23 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+// Drives the time marching method without any dependency on the interface,
+// so it can be shared between the graphical application and the command line solver
+namespace Solver {
+enum Status {
+	RUNNING,
+	CONVERGED, // error below the tolerance
+	STALLED, // error on a plateau
+	DIVERGED,
+};
+
+void setup(const std::function<void(std::string)> &log);
+double iterate();
+// fluxes of the current solution without updating it, needs the mean gradient
+void computeFlux();
+// convergence controller, called with the error of each iteration
+// stops at the tolerance or on a plateau, and adapts the CFL when enabled
+Status control(double error, const std::function<void(std::string)> &log);
+}
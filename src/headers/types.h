@@ -1,7 +1,10 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <cstddef>
 #include <map>
+#include <new>
 #include <string>
 #include <vector>
 
@@ -9,12 +12,60 @@
 // for some reason, the compiler in windows and mac does not recognize uint
 typedef unsigned int uint;
 
+// widest SIMD register (AVX-512) in doubles and bytes
+constexpr uint SIMD_WIDTH = 8;
+constexpr std::size_t SIMD_ALIGNMENT = SIMD_WIDTH * sizeof(double);
+
+template <typename T>
+struct AlignedAllocator {
+	typedef T value_type;
+
+	AlignedAllocator() = default;
+	template <typename U>
+	AlignedAllocator(const AlignedAllocator<U> &) {}
+
+	T *allocate(std::size_t size) {
+		return static_cast<T *>(::operator new(size * sizeof(T), std::align_val_t(SIMD_ALIGNMENT)));
+	}
+	void deallocate(T *pointer, std::size_t) {
+		::operator delete(pointer, std::align_val_t(SIMD_ALIGNMENT));
+	}
+
+	template <typename U>
+	bool operator==(const AlignedAllocator<U> &) const { return true; }
+	template <typename U>
+	bool operator!=(const AlignedAllocator<U> &) const { return false; }
+};
+
+// contiguous stream of values for a structure of arrays layout
+// aligned and padded to the SIMD width, so the vectorized kernels can load full registers
+typedef std::vector<double, AlignedAllocator<double>> Stream;
+
+inline std::size_t padded(std::size_t size) {
+	return (size + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+}
+
 struct Input {
 	double uInitial;
 	bool resume;
+	bool restart = false; // resumed from a checkpoint, which restores the time step and CFL the run had reached
 	double cfl;
 	uint targetIter;
 	double diffusiveWeight;
+	uint threads = 0; // 0 uses all the available cores
+	bool gather = true; // node based vertex gradient and diffusive flux instead of colored scatter
+	bool fused = true; // single sweep over the nodes after the mean gradient, requires gather
+	bool storedGradient = true; // mean gradient from the gradient operator computed with the geometry instead of the coordinates
+	bool reorder = false; // renumbers the nodes and tetrahedra of the mesh after reading it, for memory locality
+	bool localTimeStep = false; // each node advances with its own stable time step instead of the global one
+	double activeThreshold = 0; // nodes whose update residual is below it are skipped between revalidations of the whole mesh, 0 disables it, requires fused
+	bool sweep = false; // Gauss-Seidel update of the nodes in the order of the burn instead of Jacobi, with the node kernel
+	bool implicit = false; // solves the steady state with Newton-Krylov and pseudo transient continuation instead of the explicit time marching
+	bool fastMarching = false; // initializes a new computation with the arrival time from the inlets instead of the initial value
+	double tolerance = 0; // the iteration loop stops when the error is below it, 0 disables it
+	uint plateau = 0; // the iteration loop stops when the error has not improved by 1% in this number of iterations, 0 disables it
+	bool adaptiveCfl = false; // grows the CFL while the error decreases, rolls back and reduces it when the error spikes
+	std::string geometryCache = ""; // file where the geometry is saved and read from in later runs, empty to disable it
 };
 
 struct Mesh {
@@ -23,43 +74,117 @@ struct Mesh {
 	std::vector<std::array<uint, 4>> tetrahedra;
 };
 
+// structure of arrays, indexed as [vertex][tetrahedra] and [vertex][component][tetrahedra]
 struct TetrahedraGeometry {
-	std::vector<std::array<double, 4>> solidAngle;
-	std::vector<std::array<double, 4>> vertexWeight;
-	std::vector<std::array<double, 4>> triangleArea;
-	std::vector<std::array<std::array<double, 3>, 4>> normal;
-	std::vector<double> jacobiDeterminant; // equal to 6 times the volume (signed) of the tetrahedra
+	std::array<Stream, 4> solidAngle;
+	std::array<Stream, 4> vertexWeight;
+	std::array<Stream, 4> triangleArea;
+	std::array<std::array<Stream, 3>, 4> normal;
+	Stream jacobiDeterminant; // equal to 6 times the volume (signed) of the tetrahedra
+	// gradient of the linear shape function of each vertex, so the mean gradient is sum(gradientOperator[vertex] * u[vertex])
+	std::array<std::array<Stream, 3>, 4> gradientOperator;
 
 	TetrahedraGeometry() = default;
 	TetrahedraGeometry(uint tetrahedra) {
-		solidAngle = triangleArea = vertexWeight = std::vector<std::array<double, 4>>(tetrahedra);
-		normal = std::vector<std::array<std::array<double, 3>, 4>>(tetrahedra);
-		jacobiDeterminant = std::vector<double>(tetrahedra);
+		solidAngle.fill(Stream(padded(tetrahedra)));
+		vertexWeight = triangleArea = solidAngle;
+		for (auto &vertex : normal)
+			vertex.fill(Stream(padded(tetrahedra)));
+		gradientOperator = normal;
+		// padding is set to 1 so the vectorized kernels do not divide by 0
+		jacobiDeterminant = Stream(padded(tetrahedra), 1);
+	}
+
+	// every stream, in a fixed order used by the geometry cache
+	std::vector<Stream *> streams() {
+		std::vector<Stream *> streams;
+		for (auto *group : {&solidAngle, &vertexWeight, &triangleArea})
+			for (auto &stream : *group)
+				streams.push_back(&stream);
+		for (auto *group : {&normal, &gradientOperator})
+			for (auto &vertex : *group)
+				for (auto &stream : vertex)
+					streams.push_back(&stream);
+		streams.push_back(&jacobiDeterminant);
+		return streams;
 	}
 };
 
+// compressed node to tetrahedra incidence, built once after reading the mesh
+// the entries of a node are in [offset[node], offset[node + 1]) and are stored as tetrahedra * 4 + vertex,
+// where vertex is the local index (0 to 3) of the node in the tetrahedra
+struct NodeIncidence {
+	std::vector<uint> offset;
+	std::vector<uint> entries;
+};
+
 struct Boundary {
 	uint type;
 	std::array<double, 3> value;
 	std::string description;
 };
 
+// gradients are stored as structure of arrays, indexed as [component][tetrahedra or node]
 struct ComputationData {
 	std::vector<double> uVertex;
-	std::vector<std::array<double, 3>> gradient;
-	std::vector<std::array<double, 3>> vertexGradient;
+	std::array<Stream, 3> gradient;
+	std::array<Stream, 3> vertexGradient;
+	std::array<Stream, 4> diffusiveFlux; // contribution of each tetrahedra to the diffusive flux of its vertices
 	std::array<std::vector<double>, 2> flux;
 
 	ComputationData() = default;
 	ComputationData(int nodes, int tetrahedra) {
 		uVertex = std::vector<double>(nodes);
-		gradient = std::vector<std::array<double, 3>>(tetrahedra);
-		vertexGradient = std::vector<std::array<double, 3>>(nodes);
+		gradient.fill(Stream(padded(tetrahedra)));
+		vertexGradient.fill(Stream(padded(nodes)));
+		diffusiveFlux.fill(Stream(padded(tetrahedra)));
 		flux.fill(std::vector<double>(nodes));
 	}
+
+	std::array<double, 3> tetrahedraGradient(uint tetrahedra) const {
+		return {gradient[0][tetrahedra], gradient[1][tetrahedra], gradient[2][tetrahedra]};
+	}
+	std::array<double, 3> nodeGradient(uint node) const {
+		return {vertexGradient[0][node], vertexGradient[1][node], vertexGradient[2][node]};
+	}
+	void setNodeGradient(uint node, const std::array<double, 3> &value) {
+		for (uint component = 0; component < 3; ++component)
+			vertexGradient[component][node] = value[component];
+	}
 };
 
 struct IsocontourData {
 	std::vector<std::array<double, 3>> nodes;
 	std::vector<std::array<uint, 3>> triangles;
 };
+
+// static centered interval tree over the [min u, max u] range of each tetrahedra,
+// so an isosurface only visits the tetrahedra crossing its level
+// each tree node holds the ranges containing its center, in [begin, end) of both orderings
+struct IsosurfaceIndex {
+	struct Node {
+		double center;
+		uint begin;
+		uint end;
+		int left;
+		int right;
+	};
+	// cleared by the solver thread whenever u changes and by the mesh reader, the tree is only built, read and released
+	// on the interface thread
+	std::atomic<bool> built{false};
+	std::vector<double> minimum;
+	std::vector<double> maximum;
+	std::vector<Node> nodes;
+	std::vector<uint> byMinimum; // increasing minimum
+	std::vector<uint> byMaximum; // decreasing maximum
+
+	// releases the memory of the tree
+	void clear() {
+		built = false;
+		std::vector<double>().swap(minimum);
+		std::vector<double>().swap(maximum);
+		std::vector<Node>().swap(nodes);
+		std::vector<uint>().swap(byMinimum);
+		std::vector<uint>().swap(byMaximum);
+	}
+};
@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <src/headers/globals.h>
+#include <src/headers/implicit.h>
+#include <src/headers/operations.h>
+#include <src/headers/parallel.h>
+#include <src/headers/solver.h>
+
+using namespace std;
+using namespace Vectors;
+
+namespace Implicit {
+namespace {
+const uint krylovSize = 30;
+const uint maxRestarts = 2;
+// reduction of the linear residual at which GMRES stops, the Newton step does not need more
+const double krylovTolerance = 1e-2;
+const double maxCfl = 1e8;
+// limits the change of the CFL in a single step, when the residual jumps
+const double maxCflFactor = 10;
+// growth of the CFL while the residual decreases slowly, faster growth loses the front on slender grains
+const double minCflGrowth = 1.05;
+// a step that multiplies the residual by more than this is undone, and retried with the CFL reduced by backoffFactor
+const double rejectionFactor = 2;
+const double backoffFactor = 0.25;
+
+// growth of the CFL of the local steps over input.cfl, so the changes of the convergence controller apply
+double growth;
+double lastNorm;
+// last accepted solution, with its residual, error and pseudo time
+double previousError;
+double previousTimeTotal;
+vector<double> previous;
+vector<double> previousResidual;
+vector<double> localStep;
+vector<double> residual;
+vector<double> solution;
+vector<double> perturbed;
+vector<double> correction;
+// GMRES workspace, allocated by the setup
+vector<vector<double>> basis;
+vector<vector<double>> hessenberg;
+vector<double> cosine;
+vector<double> sine;
+vector<double> rhs;
+vector<double> coefficient;
+vector<double> preconditioned;
+// preconditioner: every node depends on its diagonal and on the neighbour of steepest descent, which has a lower u,
+// so the nodes in increasing u are a topological order and the preconditioner is solved exactly in a single sweep
+vector<uint> order;
+vector<uint> upwind;
+vector<double> coupling;
+vector<double> diagonal;
+
+// sums in thread order, so the result does not depend on scheduling
+double dot(const vector<double> &a, const vector<double> &b) {
+	static vector<double> sums;
+	sums.assign(Parallel::threads(), 0);
+	Parallel::forRange(a.size(), [&](uint begin, uint end, uint thread) {
+		auto sum = 0.0;
+		for (uint node = begin; node < end; ++node)
+			sum += a[node] * b[node];
+		sums[thread] = sum;
+	});
+	return accumulate(sums.begin(), sums.end(), 0.0);
+}
+
+// residual of the current uVertex, the same update of the explicit iteration
+void computeResidual(vector<double> &result) {
+	Tetrahedra::computeMeanGradient();
+	Solver::computeFlux();
+	const auto &flux = computationData.flux;
+	Parallel::forRange(mesh.nodes.size(), [&](uint begin, uint end, uint) {
+		for (uint node = begin; node < end; ++node)
+			result[node] = flux[0][node] + input.diffusiveWeight * recession[node] * flux[1][node];
+	});
+}
+
+// (1 / localStep - J) * direction, with J * direction = (R(u + epsilon * direction) - R(u)) / epsilon
+void applyOperator(const vector<double> &direction, vector<double> &result) {
+	const auto norm = sqrt(dot(direction, direction));
+	if (norm == 0) {
+		fill(result.begin(), result.end(), 0);
+		return;
+	}
+	// perturbs each node by about sqrt(machine epsilon) of its magnitude
+	const auto nodes = mesh.nodes.size();
+	const auto epsilon = 1e-7 * (1 + sqrt(dot(solution, solution) / nodes)) * sqrt(nodes) / norm;
+	auto &u = computationData.uVertex;
+	Parallel::forRange(nodes, [&](uint begin, uint end, uint) {
+		for (uint node = begin; node < end; ++node)
+			u[node] = solution[node] + epsilon * direction[node];
+	});
+	computeResidual(perturbed);
+	Parallel::forRange(nodes, [&](uint begin, uint end, uint) {
+		for (uint node = begin; node < end; ++node) {
+			u[node] = solution[node];
+			result[node] = direction[node] / localStep[node] - (perturbed[node] - residual[node]) / epsilon;
+		}
+	});
+}
+
+// linearization of 1 - recession * (steepest descent to a neighbour through the tetrahedra) at the current solution
+void computePreconditioner() {
+	const auto &u = solution;
+	Parallel::forRange(mesh.nodes.size(), [&](uint begin, uint end, uint) {
+		for (uint node = begin; node < end; ++node) {
+			coupling[node] = 0;
+			diagonal[node] = 1 / localStep[node];
+			if (boundaryConditions[node] == INLET)
+				continue;
+			auto slope = 0.0;
+			auto distance = 0.0;
+			for (auto entry = nodeIncidence.offset[node]; entry < nodeIncidence.offset[node + 1]; ++entry) {
+				for (auto &neighbour : mesh.tetrahedra[nodeIncidence.entries[entry] / 4]) {
+					if (u[neighbour - 1] >= u[node])
+						continue;
+					const auto length = magnitude(subtraction(mesh.nodes[neighbour - 1], mesh.nodes[node]));
+					if ((u[node] - u[neighbour - 1]) / length > slope) {
+						slope = (u[node] - u[neighbour - 1]) / length;
+						distance = length;
+						upwind[node] = neighbour - 1;
+					}
+				}
+			}
+			if (slope > 0) {
+				coupling[node] = Nodes::nodeRecession(node) / distance;
+				diagonal[node] += coupling[node];
+			}
+		}
+	});
+	iota(order.begin(), order.end(), 0);
+	sort(order.begin(), order.end(), [&](uint a, uint b) { return u[a] < u[b]; });
+}
+
+void applyPreconditioner(const vector<double> &direction, vector<double> &result) {
+	for (auto &node : order)
+		result[node] = (direction[node] + (coupling[node] > 0 ? coupling[node] * result[upwind[node]] : 0)) / diagonal[node];
+}
+
+// restarted GMRES with right preconditioning, returns the correction in result
+void solve(vector<double> &result) {
+	const auto nodes = mesh.nodes.size();
+	fill(result.begin(), result.end(), 0);
+	const auto target = krylovTolerance * sqrt(dot(residual, residual));
+
+	for (uint restart = 0; restart <= maxRestarts; ++restart) {
+		// linear residual of the current correction
+		auto &start = basis[0];
+		applyOperator(result, start);
+		for (uint node = 0; node < nodes; ++node)
+			start[node] = residual[node] - start[node];
+		auto beta = sqrt(dot(start, start));
+		if (beta <= target)
+			return;
+		for (auto &value : start)
+			value /= beta;
+		fill(rhs.begin(), rhs.end(), 0);
+		rhs[0] = beta;
+
+		uint size = 0;
+		while (size < krylovSize && abs(rhs[size]) > target) {
+			auto &next = basis[size + 1];
+			applyPreconditioner(basis[size], preconditioned);
+			applyOperator(preconditioned, next);
+			// modified Gram-Schmidt
+			for (uint row = 0; row <= size; ++row) {
+				auto &value = hessenberg[row][size];
+				value = dot(next, basis[row]);
+				for (uint node = 0; node < nodes; ++node)
+					next[node] -= value * basis[row][node];
+			}
+			auto norm = sqrt(dot(next, next));
+			hessenberg[size + 1][size] = norm;
+			if (norm > 0) {
+				for (auto &value : next)
+					value /= norm;
+			}
+
+			for (uint row = 0; row < size; ++row) {
+				const auto value = cosine[row] * hessenberg[row][size] + sine[row] * hessenberg[row + 1][size];
+				hessenberg[row + 1][size] = -sine[row] * hessenberg[row][size] + cosine[row] * hessenberg[row + 1][size];
+				hessenberg[row][size] = value;
+			}
+			const auto radius = hypot(hessenberg[size][size], hessenberg[size + 1][size]);
+			cosine[size] = hessenberg[size][size] / radius;
+			sine[size] = hessenberg[size + 1][size] / radius;
+			hessenberg[size][size] = radius;
+			hessenberg[size + 1][size] = 0;
+			rhs[size + 1] = -sine[size] * rhs[size];
+			rhs[size] *= cosine[size];
+			++size;
+			if (norm == 0)
+				break;
+		}
+
+		// correction from the least squares solution of the triangular system
+		for (uint row = size; row-- > 0;) {
+			auto value = rhs[row];
+			for (uint column = row + 1; column < size; ++column)
+				value -= hessenberg[row][column] * coefficient[column];
+			coefficient[row] = value / hessenberg[row][row];
+		}
+		auto &combination = basis[krylovSize];
+		fill(combination.begin(), combination.end(), 0);
+		for (uint column = 0; column < size; ++column)
+			for (uint node = 0; node < nodes; ++node)
+				combination[node] += coefficient[column] * basis[column][node];
+		applyPreconditioner(combination, preconditioned);
+		for (uint node = 0; node < nodes; ++node)
+			result[node] += preconditioned[node];
+		if (abs(rhs[size]) <= target)
+			return;
+	}
+}
+}
+
+void setup() {
+	const auto nodes = mesh.nodes.size();
+	localStep = vector<double>(nodes);
+	residual = solution = perturbed = correction = coupling = diagonal = preconditioned = vector<double>(nodes);
+	order = upwind = vector<uint>(nodes);
+	basis = vector<vector<double>>(krylovSize + 1, vector<double>(nodes));
+	hessenberg = vector<vector<double>>(krylovSize + 1, vector<double>(krylovSize));
+	cosine = sine = coefficient = vector<double>(krylovSize);
+	rhs = vector<double>(krylovSize + 1);
+	reset();
+}
+
+void reset() {
+	growth = 1;
+	lastNorm = numeric_limits<double>::infinity();
+	previous.clear();
+}
+
+double iterate() {
+	const auto nodes = mesh.nodes.size();
+	solution = computationData.uVertex;
+	computeResidual(residual);
+	auto error = Nodes::getError();
+	auto norm = sqrt(dot(residual, residual));
+
+	// switched evolution relaxation: the CFL grows with the reduction of the residual
+	if (!previous.empty() && !(norm <= rejectionFactor * lastNorm)) {
+		computationData.uVertex = solution = previous;
+		residual = previousResidual;
+		error = previousError;
+		timeTotal = previousTimeTotal;
+		norm = lastNorm;
+		growth *= backoffFactor;
+	} else {
+		if (!previous.empty() && norm > 0) {
+			auto factor = lastNorm / norm;
+			if (factor > 1)
+				factor = max(factor, minCflGrowth);
+			growth = min(maxCfl / input.cfl, growth * min(maxCflFactor, factor));
+		}
+		previous = solution;
+		previousResidual = residual;
+		previousError = error;
+		previousTimeTotal = timeTotal;
+		lastNorm = norm;
+	}
+	const auto cfl = input.cfl * growth;
+	auto meanStep = 0.0;
+	for (uint node = 0; node < nodes; ++node) {
+		const auto recession = Nodes::nodeRecession(node);
+		const auto height = isfinite(nodeHeight[node]) ? nodeHeight[node] : maxHeight;
+		localStep[node] = cfl * height / (recession > 0 ? recession : maxRecession);
+		meanStep += localStep[node] / nodes;
+	}
+
+	computePreconditioner();
+	solve(correction);
+	auto &u = computationData.uVertex;
+	for (uint node = 0; node < nodes; ++node) {
+		if (boundaryConditions[node] != INLET)
+			u[node] = solution[node] + correction[node];
+	}
+	timeTotal += meanStep * nodes;
+	return error;
+}
+}
@@ -2,9 +2,7 @@
 #define _USE_MATH_DEFINES
 #endif
 
-#include <QDir>
 #include <QFile>
-#include <QStandardPaths>
 #include <chrono>
 #include <cmath>
 #include <thread>
@@ -13,8 +11,11 @@
 #include "src/headers/iosystem.h"
 #include <src/headers/globals.h>
 #include <src/headers/interface.h>
+#include <src/headers/isosurfaceGeometry.h>
 #include <src/headers/operations.h>
 #include <src/headers/plotData.h>
+#include <src/headers/reorder.h>
+#include <src/headers/solver.h>
 
 #ifdef DEBUG
 #include <fenv.h>
@@ -22,9 +23,38 @@
 
 using namespace std;
 
+void clearSubstring(QString &str);
+
+void readInput() { //{{{
+	input.uInitial = root->findChild<QObject *>("initialCondition")->property("text").toDouble();
+	input.resume = root->findChild<QObject *>("resume")->property("checked").toBool();
+	input.cfl = root->findChild<QObject *>("cfl")->property("text").toDouble();
+	input.targetIter = root->findChild<QObject *>("targetIter")->property("text").toInt();
+	if (input.targetIter == 0)
+		input.targetIter = 300;
+
+	input.diffusiveWeight = root->findChild<QObject *>("diffusiveWeight")->property("text").toDouble();
+	input.threads = root->findChild<QObject *>("threads")->property("text").toInt();
+	input.localTimeStep = root->findChild<QObject *>("localTimeStep")->property("checked").toBool();
+	input.fastMarching = root->findChild<QObject *>("fastMarching")->property("checked").toBool();
+	input.implicit = root->findChild<QObject *>("implicit")->property("checked").toBool();
+	input.sweep = root->findChild<QObject *>("sweep")->property("checked").toBool();
+	input.tolerance = root->findChild<QObject *>("tolerance")->property("text").toDouble();
+	input.plateau = root->findChild<QObject *>("plateau")->property("text").toUInt();
+	input.activeThreshold = root->findChild<QObject *>("activeThreshold")->property("text").toDouble();
+	input.adaptiveCfl = root->findChild<QObject *>("adaptiveCfl")->property("checked").toBool();
+
+	auto meshPath = root->findChild<QObject *>("fileDialog")->property("fileUrl").toString();
+	clearSubstring(meshPath);
+	input.geometryCache = GeometryCache::path(meshPath.toStdString(), input.reorder);
+}
+//}}}
+
 Actions::Actions(QObject *parent) : QObject(parent) {
 	connect(this, &Actions::newOutput, this, &Actions::appendOutput);
 	connect(this, &Actions::readFinished, this, &Actions::afterReadMesh);
+	// emitted by the solver thread, so the preview and the Qt 3D nodes are only updated on the interface thread
+	connect(this, &Actions::finished, this, &Actions::afterWorker, Qt::QueuedConnection);
 }
 
 void clearSubstring(QString &str) {
@@ -70,10 +100,13 @@ void Actions::appendOutput(QString text) {
 void Actions::readMeshWorker(QString path) {
 	const QString jsonExtension = ".json";
 
-	if (path.endsWith(jsonExtension)) {
+	if (path.endsWith(jsonExtension) || path.endsWith(QString::fromStdString(Binary::extension))) {
 		auto filepath = path.toStdString();
 		try {
-			Json::readMesh(filepath);
+			if (Binary::isBinary(filepath))
+				Binary::readMesh(filepath);
+			else
+				Json::readMesh(filepath);
 		} catch (std::invalid_argument &e) {
 			emit newOutput("Error: " + QString(e.what()));
 			emit readFinished(false);
@@ -109,6 +142,8 @@ void Actions::readMesh(QString filepath) {
 }
 
 void Actions::afterReadMesh(bool sucess) {
+	// the tree of the previous mesh, which the reader thread only marked as stale
+	isosurfaceIndex.clear();
 	if (!sucess) {
 		appendOutput("Error: Failed to read mesh");
 		return;
@@ -148,58 +183,33 @@ void Actions::worker() {
 #ifdef DEBUG
 	feenableexcept(FE_DIVBYZERO | FE_INVALID | FE_OVERFLOW);
 #endif
-	if (!input.resume) {
-		currentIter = 0;
-		timeTotal = 0;
-		timeStep = 0;
-		errorIter.clear();
-		tetrahedraGeometry = TetrahedraGeometry(mesh.tetrahedra.size());
-		angleTotal = vector<double>(mesh.nodes.size());
-		computationData = ComputationData(mesh.nodes.size(), mesh.tetrahedra.size());
-		emit newOutput("--> Computing geometry");
-		Geometry::computeGeometry();
-	}
-
-	emit newOutput("--> Setting boundary conditions");
-	Nodes::setBoundaryConditions();
-
-	if (anisotropic) {
-		emit newOutput("--> Computing anisotropic matrix");
-		Anisotropic::computeMatrix();
-	}
-
-	emit newOutput("--> Getting max recession");
-	maxRecession = Nodes::getMaxRecession();
-
-	emit newOutput("--> Starting time step");
-	timeStep = maxHeight * input.cfl / (maxRecession);
+	auto log = [this](string text) { emit newOutput(QString::fromStdString(text)); };
+	Solver::setup(log);
 
 	emit newOutput("--> Starting subiteration loop");
-	if (currentIter < input.targetIter)
-		errorIter.resize(input.targetIter);
 
 	QString linesToPrint = "";
 	auto clock = std::chrono::system_clock::now();
 
 	vector<double> errors;
 	for (; currentIter < input.targetIter; ++currentIter) {
-		Tetrahedra::computeMeanGradient();
-		Tetrahedra::computeVertexGradient();
-		Nodes::applySymmetry();
-		Tetrahedra::computeDiffusiveFlux();
-		if (anisotropic)
-			Anisotropic::computeRecession();
-		Nodes::computeHamitonianFlux();;
-		Nodes::computeResults();
-
-		auto error = Nodes::getError();
+		auto error = Solver::iterate();
 		errorIter[currentIter] = error;
 
 		if (linesToPrint != "")
 			linesToPrint += "\n";
 		linesToPrint += "Iteration: " + QString::number(currentIter + 1) + " Time: " + QString::number(timeTotal) + " Error: " + QString::number(error * 100) + "%";
 
-		if (error > 1) {
+		auto status = Solver::control(error, log);
+		if (status == Solver::CONVERGED || status == Solver::STALLED) {
+			errorIter.resize(++currentIter);
+			emit newOutput(linesToPrint);
+			emit updateProgress(currentIter, currentIter);
+			emit newOutput(status == Solver::CONVERGED ? "--> Converged below the tolerance" : "--> Error stalled");
+			emit finished();
+			return;
+		}
+		if (status == Solver::DIVERGED) {
 			if (linesToPrint != "") {
 				emit newOutput(linesToPrint);
 				emit updateProgress(currentIter + 1, input.targetIter);
@@ -207,7 +217,7 @@ void Actions::worker() {
 			emit newOutput("Error: Divergence detected. Stopping. Try reducing the CFL.");
 			emit newOutput("--> Stopped");
 			root->findChild<QObject *>("runButton")->setProperty("text", "Run");
-			afterWorker();
+			emit finished();
 			return;
 		}
 
@@ -220,7 +230,7 @@ void Actions::worker() {
 			if (!running) {
 				emit newOutput("--> Stopped");
 				root->findChild<QObject *>("runButton")->setProperty("text", "Run");
-				afterWorker();
+				emit finished();
 				return;
 			}
 		}
@@ -232,7 +242,7 @@ void Actions::worker() {
 	}
 
 	emit newOutput("--> Subiteration ended");
-	afterWorker();
+	emit finished();
 }
 
 void Actions::afterWorker() {
@@ -240,18 +250,11 @@ void Actions::afterWorker() {
 	auto &max_uVertex = *std::max_element(computationData.uVertex.begin(), computationData.uVertex.end());
 	root->findChild<QObject *>("isosurfaceSlider")->setProperty("to", max_uVertex);
 
-	// make sure the directory exists
-	QDir dir(tmpDir);
-	if (!dir.exists())
-		dir.mkpath(tmpDir);
-
 	auto nodes = vector<double>(mesh.nodes.size());
 	for (uint i = 0; i < mesh.nodes.size(); ++i) {
 		nodes[i] = mesh.nodes[i][2];
 	}
 
-	WriteMesh::Material();
-	WriteMesh::Boundary();
 	double minx = 0, miny = 0, minz = 0, maxx = 0, maxy = 0, maxz = 0;
 	for (auto &node : mesh.nodes) {
 		minx = min(minx, node[0]);
@@ -268,23 +271,13 @@ void Actions::afterWorker() {
 
 	emit setCameraPosition(x, y, z);
 
+	buildIsosurfaceIndex();
 	double isosurfaceValue = root->findChild<QObject *>("isosurfaceSlider")->property("value").toDouble();
 	previewIsosurface(isosurfaceValue);
 }
 
 void Actions::previewIsosurface(double value) {
-
-#ifdef _WIN32
-	const QString substring = "file:///";
-#else
-	const QString substring = "file://";
-#endif
-
-	auto filepath = tmpDir + "surface" + QString::number(drawCount) + ".obj";
-	auto url = substring + filepath;
-	WriteMesh::IsocontourSurface(value, filepath.toStdString());
-	emit loadMeshPreview(url);
-	drawCount++;
+	root->findChild<IsosurfaceGeometry *>("isosurfaceGeometry")->setSurface(isosurfaceData(value));
 }
 
 void Actions::updateIsosurface(double value) {
@@ -292,13 +285,6 @@ void Actions::updateIsosurface(double value) {
 		previewIsosurface(value);
 }
 
-void Actions::clearCache() {
-	if (tmpDir == "")
-		return;
-	QDir dir(tmpDir);
-	dir.removeRecursively();
-}
-
 void Actions::setCullingMethod(uint method) {
 	emit setCulling(method);
 }
@@ -310,7 +296,8 @@ void Actions::exportData(QString filepath, bool pretty) {
 	clearSubstring(origin);
 
 	// add .json if filepath doesn't have it
-	if (!filepath.endsWith(".json"))
+	auto binaryResults = Binary::isResults(filepath.toStdString());
+	if (!binaryResults && !filepath.endsWith(".json"))
 		filepath += ".json";
 
 	auto originPath = origin.toStdString();
@@ -318,7 +305,10 @@ void Actions::exportData(QString filepath, bool pretty) {
 
 	appendOutput("Exporting data to " + filepath);
 	try {
-		Json::writeData(filePath, originPath, pretty);
+		if (binaryResults)
+			Binary::writeResults(filePath);
+		else
+			Json::writeData(filePath, originPath, pretty);
 	} catch (const std::exception &e) {
 		appendOutput("Error while exporting data: " + QString(e.what()));
 	} catch (...) {
@@ -417,7 +407,7 @@ void Actions::updateRecessions(QString recessions, bool saveToFile, bool pretty)
 			recessionAnisotropic = vector<array<double, 6>>(mesh.nodes.size());
 			anisotropic = true;
 			for (uint node = 0; node < mesh.nodes.size(); ++node) {
-				auto values = recessionsList[node].simplified().split(" ");
+				auto values = recessionsList[Reorder::originalNode(node)].simplified().split(" ");
 				recessionAnisotropic[node][0] = values[0].toDouble();
 				recessionAnisotropic[node][1] = values[1].toDouble();
 				recessionAnisotropic[node][2] = values[2].toDouble();
@@ -430,7 +420,7 @@ void Actions::updateRecessions(QString recessions, bool saveToFile, bool pretty)
 			recessionAnisotropic.clear();
 			recessionMatrix.clear();
 			for (uint node = 0; node < mesh.nodes.size(); ++node) {
-				recession[node] = recessionsList[node].toDouble();
+				recession[node] = recessionsList[Reorder::originalNode(node)].toDouble();
 			}
 			appendOutput("Recessions updated to isotropic");
 			return;
@@ -461,7 +451,7 @@ void Actions::updateRecessions(QString recessions, bool saveToFile, bool pretty)
 QString Actions::getRecession() {
 	QString output = "";
 	if (anisotropic) {
-		for (const auto &value : recessionAnisotropic) {
+		for (const auto &value : Reorder::toOriginal(recessionAnisotropic, nodePermutation)) {
 			for (const auto &value2 : value)
 				output += QString::number(value2) + " ";
 			output += "\n";
@@ -469,7 +459,7 @@ QString Actions::getRecession() {
 		output.chop(1);
 		return output;
 	}
-	for (const auto &value : recession) {
+	for (const auto &value : Reorder::toOriginal(recession, nodePermutation)) {
 		output += QString::number(value) + "\n";
 	}
 	output.chop(1);
@@ -5,63 +5,313 @@
 #include <src/headers/globals.h>
 #include <src/headers/iosystem.h>
 #include <src/headers/operations.h>
-#include <src/headers/plotData.h>
+#include <src/headers/reorder.h>
 // #include <src/headers/interface.h>
 
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <nlohmann/json.hpp>
+#include <set>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 using json = nlohmann::json;
 
-void readInput() { //{{{
-	input.uInitial = root->findChild<QObject *>("initialCondition")->property("text").toDouble();
-	input.resume = root->findChild<QObject *>("resume")->property("checked").toBool();
-	input.cfl = root->findChild<QObject *>("cfl")->property("text").toDouble();
-	input.targetIter = root->findChild<QObject *>("targetIter")->property("text").toInt();
-	if (input.targetIter == 0)
-		input.targetIter = 300;
+namespace Conditions { //{{{
+// shared by the mesh readers once the mesh, boundaries, triangle conditions and recessions are read
+// sets the conditions of each node and prepares the data that only depends on the mesh
+void setNodeConditions() {
+	try {
+		boundaries.insert(pair<int, Boundary>(0, Boundary{0, {0, 0}, ""}));
+		nodeConditions = vector<vector<uint>>(mesh.nodes.size());
+		boundaryConditions = vector<uint>(mesh.nodes.size());
+		uint triangleIndex = 0;
+		for (auto &condition : triangleConditions) {
+			auto &triangle = mesh.triangles.at(triangleIndex);
+			if (boundaries[condition].type == SYMMETRY &&
+			    boundaries[condition].value == array<double, 3>{0, 0, 0}) {
+				auto &node1 = mesh.nodes[triangle[0] - 1];
+				auto &node2 = mesh.nodes[triangle[1] - 1];
+				auto &node3 = mesh.nodes[triangle[2] - 1];
 
-	input.diffusiveWeight = root->findChild<QObject *>("diffusiveWeight")->property("text").toDouble();
+				auto vector1 = Vectors::subtraction(node2, node1);
+				auto vector2 = Vectors::subtraction(node3, node1);
+				auto normal = Vectors::normalization(Vectors::crossProduct(vector2, vector1));
+
+				boundaries[condition].value = normal;
+			}
+			for (auto &_node : triangle) {
+				auto node = _node - 1;
+				// check if condition already exists
+				if (find(nodeConditions[node].begin(), nodeConditions[node].end(), condition) != nodeConditions[node].end())
+					continue;
+				nodeConditions[node].push_back(condition);
+			}
+			triangleIndex++;
+		}
+	} catch (...) {
+		throw std::invalid_argument("Unable to read boundary conditions. Wrong format?");
+	}
+
+	// the geometry is kept, the solver only computes it again if the mesh changed
+	// the index is only marked stale here, on the reader thread, its tree is released on the interface thread
+	tetrahedraColors.clear();
+	isosurfaceIndex.built = false;
+	Nodes::computeIncidence();
+	if (input.reorder)
+		Reorder::reorderMesh();
 }
-//}}}
+} //}}}
 
 namespace Json { //{{{
-void readMesh(std::string &filepath) {
-	fstream file(filepath);
-	json json;
+// SAX handler filling the mesh, triangle conditions and recessions while the file is read,
+// so the document is never held in memory. Only the short list of boundaries is built as a json value
+class MeshReader : public nlohmann::json_sax<json> {
+public:
+	json boundaryData;
+	set<std::string> fields;
+	set<std::string> meshFields;
+	std::string error;
+
+	bool null() override { return value(nullptr); }
+	bool boolean(bool data) override { return value(data); }
+	bool number_integer(number_integer_t data) override { return section == NONE ? value(data) : number(data); }
+	bool number_unsigned(number_unsigned_t data) override { return section == NONE ? value(data) : number(data); }
+	bool number_float(number_float_t data, const string_t &) override { return section == NONE ? value(data) : number(data); }
+	bool string(string_t &data) override { return value(data); }
+	bool binary(binary_t &data) override { return value(data); }
+
+	bool key(string_t &data) override {
+		currentKey = data;
+		if (depth == 1)
+			fields.insert(currentKey);
+		if (depth == 2 && currentField == "mesh" && (currentKey == "nodes" || currentKey == "triangles" || currentKey == "tetrahedra"))
+			meshFields.insert(currentKey);
+		return true;
+	}
+	bool start_object(std::size_t) override {
+		if (section != NONE)
+			return fail();
+		return start(json::object());
+	}
+	bool start_array(std::size_t) override {
+		if (section != NONE) {
+			// elements of the sections are arrays of numbers
+			if (depth != 3)
+				return fail();
+			components = 0;
+			++depth;
+			return true;
+		}
+		if (depth == 2 && currentField == "mesh" && currentKey == "nodes")
+			section = NODES;
+		else if (depth == 2 && currentField == "mesh" && currentKey == "triangles")
+			section = TRIANGLES;
+		else if (depth == 2 && currentField == "mesh" && currentKey == "tetrahedra")
+			section = TETRAHEDRA;
+		else if (depth == 2 && currentField == "conditions" && currentKey == "triangle")
+			section = TRIANGLE_CONDITIONS;
+		else if (depth == 2 && currentField == "conditions" && currentKey == "recession")
+			section = RECESSION;
+		if (section == NONE)
+			return start(json::array());
+		clearSection();
+		++depth;
+		return true;
+	}
+	bool end_object() override {
+		return end();
+	}
+	bool end_array() override {
+		if (section == NONE)
+			return end();
+		if (depth == 4 && !record())
+			return false;
+		if (depth == 3)
+			section = NONE;
+		--depth;
+		return true;
+	}
+	bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &) override {
+		error = "Unable to parse JSON file. Invalid JSON file?";
+		return false;
+	}
+
+private:
+	enum Section {
+		NONE,
+		NODES,
+		TRIANGLES,
+		TETRAHEDRA,
+		TRIANGLE_CONDITIONS,
+		RECESSION
+	};
+	Section section = NONE;
+	// number of open objects and arrays
+	uint depth = 0;
+	std::string currentKey;
+	// first level field being read (metaData, mesh, conditions...)
+	std::string currentField;
+	// values of the element being read, for the sections that are arrays of arrays
+	array<double, 6> values;
+	uint components = 0;
+	// open containers of the boundary list
+	vector<json *> boundaryStack;
+
+	bool start(json container) {
+		if (depth == 1)
+			currentField = currentKey;
+		if (depth == 2 && currentField == "conditions" && currentKey == "boundary") {
+			boundaryData = container;
+			boundaryStack = {&boundaryData};
+		} else if (!boundaryStack.empty()) {
+			boundaryStack.push_back(add(container));
+		}
+		++depth;
+		return true;
+	}
+	bool end() {
+		--depth;
+		if (!boundaryStack.empty())
+			boundaryStack.pop_back();
+		return true;
+	}
+	json *add(const json &data) {
+		auto &parent = *boundaryStack.back();
+		if (parent.is_object())
+			return &(parent[currentKey] = data);
+		parent.push_back(data);
+		return &parent.back();
+	}
+	bool value(const json &data) {
+		if (section != NONE)
+			return fail();
+		if (!boundaryStack.empty())
+			add(data);
+		return true;
+	}
+
+	void clearSection() {
+		switch (section) {
+			case NODES:
+				mesh.nodes.clear();
+				break;
+			case TRIANGLES:
+				mesh.triangles.clear();
+				break;
+			case TETRAHEDRA:
+				mesh.tetrahedra.clear();
+				break;
+			case TRIANGLE_CONDITIONS:
+				triangleConditions.clear();
+				break;
+			case RECESSION:
+				recession.clear();
+				recessionAnisotropic.clear();
+				break;
+			default:
+				break;
+		}
+	}
+	bool number(double data) {
+		if (depth == 4) {
+			if (components == values.size())
+				return fail();
+			values[components++] = data;
+			return true;
+		}
+		if (section == TRIANGLE_CONDITIONS) {
+			triangleConditions.push_back(data);
+			return true;
+		}
+		if (section == RECESSION && recessionAnisotropic.empty()) {
+			recession.push_back(data);
+			return true;
+		}
+		return fail();
+	}
+	bool record() {
+		switch (section) {
+			case NODES:
+				if (components != 3)
+					return fail();
+				mesh.nodes.push_back({values[0], values[1], values[2]});
+				return true;
+			case TRIANGLES:
+				if (components != 3)
+					return fail();
+				mesh.triangles.push_back({uint(values[0]), uint(values[1]), uint(values[2])});
+				return true;
+			case TETRAHEDRA:
+				if (components != 4)
+					return fail();
+				mesh.tetrahedra.push_back({uint(values[0]), uint(values[1]), uint(values[2]), uint(values[3])});
+				return true;
+			case RECESSION:
+				if (components != 6 || !recession.empty())
+					return fail();
+				recessionAnisotropic.push_back(values);
+				return true;
+			default:
+				return fail();
+		}
+	}
+	bool fail() {
+		if (section == RECESSION)
+			error = "Unable to read recession conditions from JSON file. Wrong format?";
+		else if (section == TRIANGLE_CONDITIONS)
+			error = "Unable to read boundary conditions from JSON file. Missing boundary field or wrong format?";
+		else
+			error = "Unable to read mesh from JSON file. Missing mesh field or wrong format?";
+		return false;
+	}
+};
 
+void readMesh(std::string &filepath) {
+	ifstream file(filepath, ios::binary);
+	MeshReader reader;
+	mesh = Mesh();
+	triangleConditions.clear();
+	recession.clear();
+	recessionAnisotropic.clear();
+	nodePermutation.clear();
+	tetrahedraPermutation.clear();
+
+	bool parsed = false;
 	try {
-		json = json::parse(file);
+		parsed = json::sax_parse(file, &reader);
 	} catch (...) {
 		throw std::invalid_argument("Unable to parse JSON file. Invalid JSON file?");
 	}
+	if (!parsed)
+		throw std::invalid_argument(reader.error.empty() ? "Unable to parse JSON file. Invalid JSON file?" : reader.error);
 
 	for (auto &key : {"metaData", "mesh", "conditions"}) {
-		if (json.find(key) == json.end())
+		if (reader.fields.find(key) == reader.fields.end())
 			throw std::invalid_argument("Unable to read mesh data from JSON file. Missing " + string(key) + " field.");
 	}
-
-	try {
-		auto &meshData = json["mesh"];
-		mesh.nodes = meshData["nodes"];
-		mesh.triangles = meshData["triangles"];
-		mesh.tetrahedra = meshData["tetrahedra"];
-	} catch (...) {
+	if (reader.meshFields.size() != 3)
 		throw std::invalid_argument("Unable to read mesh from JSON file. Missing mesh field or wrong format?");
-	}
 
-	auto &conditions = json["conditions"];
 	try {
 		boundaries.clear();
-		nodeConditions = vector<vector<uint>>(mesh.nodes.size());
-		for (auto &boundary : conditions["boundary"]) {
+		for (auto &boundary : reader.boundaryData) {
 			auto &tag = boundary["tag"];
 			if (tag < 1)
 				throw std::invalid_argument("Boundary tag must be greater than 0");
 			string type = boundary.value("type", "outlet");
 			string description = boundary.value("description", "");
-			array<double, 3> value = std::array<double, 3>({0, 0, 0});
+			array<double, 3> value = boundary.value("value", std::array<double, 3>({0, 0, 0}));
 
 			const vector<string> boundaryTypes = {"inlet", "outlet", "symmetry"};
 			// if (type == "symmetry") {
@@ -71,87 +321,140 @@ void readMesh(std::string &filepath) {
 			uint typeInt = find(boundaryTypes.begin(), boundaryTypes.end(), type) - boundaryTypes.begin() + 1;
 			boundaries.insert(pair<int, Boundary>(tag, Boundary{typeInt, value, description}));
 		}
-		boundaries.insert(pair<int, Boundary>(0, Boundary{0, {0, 0}, ""}));
-		boundaryConditions = vector<uint>(mesh.nodes.size());
-		uint triangleIndex = 0;
-		for (auto &condition : conditions["triangle"]) {
-			auto &triangle = mesh.triangles[triangleIndex];
-			if (boundaries[condition].type == SYMMETRY &&
-			    boundaries[condition].value == array<double, 3>{0, 0, 0}) {
-				auto &node1 = mesh.nodes[triangle[0] - 1];
-				auto &node2 = mesh.nodes[triangle[1] - 1];
-				auto &node3 = mesh.nodes[triangle[2] - 1];
-
-				auto vector1 = Vectors::subtraction(node2, node1);
-				auto vector2 = Vectors::subtraction(node3, node1);
-				auto normal = Vectors::normalization(Vectors::crossProduct(vector2, vector1));
-
-				boundaries[condition].value = normal;
-			}
-			for (auto &_node : triangle) {
-				auto node = _node - 1;
-				// check if condition already exists
-				if (find(nodeConditions[node].begin(), nodeConditions[node].end(), condition) != nodeConditions[node].end())
-					continue;
-				nodeConditions[node].push_back(condition);
-			}
-			triangleIndex++;
-		}
 	} catch (...) {
 		throw std::invalid_argument("Unable to read boundary conditions from JSON file. Missing boundary field or wrong format?");
 	}
 
-	if (conditions.find("recession") != conditions.end()) {
-		try {
-			try {
-				auto recessionCondition = conditions["recession"].get<vector<double>>();
-				if (recessionCondition.size() == 0)
-					recession = vector<double>(mesh.nodes.size(), 1);
-				else
-					recession = recessionCondition;
-				recessionAnisotropic.clear();
-				recessionMatrix.clear();
-				anisotropic = false;
-			} catch (...) {
-				auto recessionCondition = conditions["recession"].get<vector<array<double, 6>>>();
-				recession = vector<double>(mesh.nodes.size());
-				recessionAnisotropic = recessionCondition;
-				anisotropic = true;
-			}
-		} catch (...) {
-			throw std::invalid_argument("Unable to read recession conditions from JSON file. Wrong format?");
-		}
-	} else {
+	recessionMatrix.clear();
+	anisotropic = !recessionAnisotropic.empty();
+	if (anisotropic)
+		recession = vector<double>(mesh.nodes.size());
+	else if (recession.empty())
 		recession = vector<double>(mesh.nodes.size(), 1);
-		recessionAnisotropic.clear();
-		recessionMatrix.clear();
-		anisotropic = false;
+
+	Conditions::setNodeConditions();
+}
+// minimal scanner of the JSON text, used to find the byte range of a value without parsing the document
+size_t skipWhitespace(const string &text, size_t position) {
+	while (position < text.size() && isspace(static_cast<unsigned char>(text[position])))
+		++position;
+	return position;
+}
+size_t skipString(const string &text, size_t position) {
+	for (++position; position < text.size(); ++position) {
+		if (text[position] == '\\')
+			++position;
+		else if (text[position] == '"')
+			return position + 1;
+	}
+	throw std::invalid_argument("Unable to parse JSON file. Invalid JSON file?");
+}
+// returns the position after the value starting at position
+size_t skipValue(const string &text, size_t position) {
+	if (position >= text.size())
+		throw std::invalid_argument("Unable to parse JSON file. Invalid JSON file?");
+	if (text[position] == '"')
+		return skipString(text, position);
+	if (text[position] != '{' && text[position] != '[') {
+		while (position < text.size() && !strchr(",}] \t\r\n", text[position]))
+			++position;
+		return position;
+	}
+	uint depth = 0;
+	while (position < text.size()) {
+		const auto character = text[position];
+		if (character == '"') {
+			position = skipString(text, position);
+			continue;
+		}
+		if (character == '{' || character == '[')
+			++depth;
+		else if ((character == '}' || character == ']') && --depth == 0)
+			return position + 1;
+		++position;
+	}
+	throw std::invalid_argument("Unable to parse JSON file. Invalid JSON file?");
+}
+// range [begin, end) of the value of the key in the object starting at position,
+// begin is the position after the opening brace of the object when the key is not found
+pair<size_t, size_t> findValue(const string &text, size_t position, const string &key, bool &found) {
+	position = skipWhitespace(text, position);
+	if (position >= text.size() || text[position] != '{')
+		throw std::invalid_argument("Unable to parse JSON file. Invalid JSON file?");
+	const auto objectBegin = position + 1;
+	position = skipWhitespace(text, objectBegin);
+	while (position < text.size() && text[position] != '}') {
+		const auto keyEnd = skipString(text, position);
+		const auto currentKey = json::parse(text.begin() + position, text.begin() + keyEnd).get<string>();
+		position = skipWhitespace(text, keyEnd);
+		if (position >= text.size() || text[position] != ':')
+			throw std::invalid_argument("Unable to parse JSON file. Invalid JSON file?");
+		const auto valueBegin = skipWhitespace(text, position + 1);
+		const auto valueEnd = skipValue(text, valueBegin);
+		if (currentKey == key) {
+			found = true;
+			return {valueBegin, valueEnd};
+		}
+		position = skipWhitespace(text, valueEnd);
+		if (position < text.size() && text[position] == ',')
+			position = skipWhitespace(text, position + 1);
+	}
+	found = false;
+	return {objectBegin, objectBegin};
+}
+
+string readText(const string &filepath) {
+	ifstream file(filepath, ios::binary);
+	if (!file.good())
+		throw std::invalid_argument("Unable to open JSON file " + filepath);
+	return string((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+}
+
+// writes the text with the range found by findValue replaced by the value,
+// or with the key added at the beginning of the object when it was not found
+void writeReplaced(const string &filepath, const string &text, pair<size_t, size_t> range, bool found, const string &key, string value) {
+	if (!found) {
+		const auto empty = text[skipWhitespace(text, range.first)] == '}';
+		value = json(key).dump() + ":" + value + (empty ? "" : ",");
 	}
 
-	tetrahedraGeometry = TetrahedraGeometry(mesh.tetrahedra.size());
-	angleTotal = std::vector<double>(mesh.nodes.size());
+	ofstream file(filepath, ios::binary | ios::trunc);
+	file.write(text.data(), range.first);
+	file << value;
+	file.write(text.data() + range.second, text.size() - range.second);
+	if (!file.good())
+		throw std::invalid_argument("Unable to write JSON file " + filepath);
+}
+
+// replaces the value of conditions.<field> in the file, copying the rest of the text as it is
+void updateCondition(const string &filepath, const string &field, const json &value, bool pretty) {
+	const auto text = readText(filepath);
+
+	bool found;
+	const auto conditions = findValue(text, 0, "conditions", found);
+	if (!found)
+		throw std::invalid_argument("Unable to read mesh data from JSON file. Missing conditions field.");
+	auto range = findValue(text, conditions.first, field, found);
+	writeReplaced(filepath, text, range, found, field, value.dump(pretty ? 4 : -1));
 }
+
+// the results are added to a copy of the original mesh file, whose text is copied as it is instead of being parsed,
+// pretty only applies to the results
 void writeData(std::string &filepath, std::string &origin, bool &pretty) {
-	fstream originalFile(origin);
 	json results;
-
-	results["uVertex"] = computationData.uVertex;
-	results["duVertex"] = computationData.gradient;
-	results["fluxes"] = computationData.flux;
+	results["uVertex"] = Reorder::toOriginal(computationData.uVertex, nodePermutation);
+	auto gradient = vector<array<double, 3>>(mesh.tetrahedra.size());
+	for (uint tetrahedra = 0; tetrahedra < mesh.tetrahedra.size(); ++tetrahedra)
+		gradient[tetrahedra] = computationData.tetrahedraGradient(tetrahedra);
+	results["duVertex"] = Reorder::toOriginal(gradient, tetrahedraPermutation);
+	results["fluxes"] = {
+	    Reorder::toOriginal(computationData.flux[0], nodePermutation),
+	    Reorder::toOriginal(computationData.flux[1], nodePermutation)};
 	results["timeStep"] = timeStep;
 	results["timeTotal"] = timeTotal;
 	// results["error"] = errorIter;
 
-	try {
-		json jsonFile = json::parse(originalFile);
-		jsonFile["burnbackResults"] = results;
-
-		ofstream file(filepath);
-		if (pretty)
-			file << setw(4) << jsonFile << endl;
-		else
-			file << jsonFile << endl;
-	} catch (...) {
+	auto writeResultsOnly = [&]() {
 		ofstream file(filepath);
 		json jsonFile;
 		jsonFile["burnbackResults"] = results;
@@ -159,17 +462,31 @@ void writeData(std::string &filepath, std::string &origin, bool &pretty) {
 			file << setw(4) << jsonFile << endl;
 		else
 			file << jsonFile << endl;
+	};
+
+	// binary meshes are not copied into the results
+	if (Binary::isBinary(origin)) {
+		writeResultsOnly();
+		return;
+	}
+
+	// read completely before writing, the results may replace the mesh file
+	string text;
+	pair<size_t, size_t> range;
+	bool found;
+	try {
+		text = readText(origin);
+		range = findValue(text, 0, "burnbackResults", found);
+	} catch (...) {
+		writeResultsOnly();
 		throw std::invalid_argument("Unable to parse JSON file. Invalid JSON file?\nA file with only results is created.");
 	}
+	writeReplaced(filepath, text, range, found, "burnbackResults", results.dump(pretty ? 4 : -1));
 }
 
 void updateBoundaries(string &filepath, bool &pretty) {
-	fstream originalFile(filepath);
-	json jsonFile;
-	try {
-		jsonFile = json::parse(originalFile);
-	} catch (...) {
-		throw std::invalid_argument("Unable to parse JSON file. Invalid JSON file?");
+	if (Binary::isBinary(filepath)) {
+		Binary::writeMesh(filepath);
 		return;
 	}
 
@@ -195,128 +512,421 @@ void updateBoundaries(string &filepath, bool &pretty) {
 		auto &boundaryDescription = boundary.description;
 		updatedBoundaries.push_back({{"tag", boundaryTag}, {"type", boundaryType}, {"value", boundaryValue}, {"description", boundaryDescription}});
 	}
-	jsonFile["conditions"]["boundary"] = updatedBoundaries;
-
-	ofstream file(filepath);
-	if (pretty)
-		file << setw(4) << jsonFile << endl;
-	else
-		file << jsonFile << endl;
+	updateCondition(filepath, "boundary", updatedBoundaries, pretty);
 }
 
 void updateRecessions(std::string &filepath, bool &pretty) {
-	fstream originalFile(filepath);
-	json jsonFile;
-	try {
-		jsonFile = json::parse(originalFile);
-	} catch (...) {
-		throw std::invalid_argument("Unable to parse JSON file. Invalid JSON file?");
+	if (Binary::isBinary(filepath)) {
+		Binary::writeMesh(filepath);
 		return;
 	}
 
 	json updatedRecessions;
 	if (anisotropic) {
-		updatedRecessions = recessionAnisotropic;
+		updatedRecessions = Reorder::toOriginal(recessionAnisotropic, nodePermutation);
 	} else {
-		updatedRecessions = recession;
+		updatedRecessions = Reorder::toOriginal(recession, nodePermutation);
 	}
-	jsonFile["conditions"]["recession"] = updatedRecessions;
-
-	ofstream file(filepath);
-	if (pretty)
-		file << setw(4) << jsonFile << endl;
-	else
-		file << jsonFile << endl;
+	updateCondition(filepath, "recession", updatedRecessions, pretty);
 }
 
 } //}}}
 
-namespace WriteMesh {
-// writes a mesh
-void IsocontourSurface(double value, std::string filepath) {
-	auto data = isosurfaceData(value);
-	ofstream file(filepath);
-	file << "# isocontour surface" << endl;
-	file << "mtllib mesh.mtl" << endl;
-	file << "usemtl opaque" << endl;
-	// write vertices
-	for (auto &node : data.nodes) {
-		file << "v"
-		     << " " << node[0] << " " << node[2] << " " << node[1] << endl;
-	}
-	// write faces
-	for (auto &triangle : data.triangles) {
-		file << "f"
-		     << " " << triangle[0] + 1 << " " << triangle[1] + 1 << " " << triangle[2] + 1 << endl;
-		// for (auto &node: triangle)
-		// 	file << " " << node + 1;
-		// file << endl;
+namespace Binary { //{{{
+const char magic[8] = {'B', 'B', '3', 'D', 'M', 'E', 'S', 'H'};
+const uint32_t version = 1;
+const uint32_t anisotropicFlag = 1;
+
+struct Header {
+	char magic[8];
+	uint32_t version;
+	uint32_t flags;
+	uint64_t nodes;
+	uint64_t triangles;
+	uint64_t tetrahedra;
+	uint64_t conditions;
+	uint64_t boundaries;
+	uint64_t descriptions;
+};
+struct BoundaryRecord {
+	uint32_t tag;
+	uint32_t type;
+	double value[3];
+	uint64_t descriptionOffset;
+	uint64_t descriptionSize;
+};
+static_assert(sizeof(Header) == 64 && sizeof(BoundaryRecord) == 48, "Unexpected padding of the binary mesh records");
+
+const char resultsMagic[8] = {'B', 'B', '3', 'D', 'R', 'S', 'L', 'T'};
+const uint32_t resultsVersion = 1;
+
+struct ResultsHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t iterations;
+	uint64_t nodes;
+	uint64_t tetrahedra;
+	uint64_t hash;
+	double timeStep;
+	double timeTotal;
+};
+static_assert(sizeof(ResultsHeader) == 56, "Unexpected padding of the binary results header");
+static_assert(sizeof(array<double, 3>) == 24 && sizeof(array<uint, 3>) == 12 && sizeof(array<uint, 4>) == 16 && sizeof(uint) == 4,
+              "The mesh arrays must match the layout of the binary mesh");
+
+bool littleEndian() {
+	const uint32_t one = 1;
+	return *reinterpret_cast<const char *>(&one) == 1;
+}
+uint64_t aligned(uint64_t offset) {
+	return (offset + 7) / 8 * 8;
+}
+
+// offsets of the sections, in the order they are stored
+struct Layout {
+	uint64_t nodes, triangles, tetrahedra, conditions, boundaries, recessions, descriptions, size;
+
+	Layout(const Header &header) {
+		const uint64_t recessionValues = header.flags & anisotropicFlag ? 6 : 1;
+		nodes = sizeof(Header);
+		triangles = aligned(nodes + header.nodes * sizeof(array<double, 3>));
+		tetrahedra = aligned(triangles + header.triangles * sizeof(array<uint, 3>));
+		conditions = aligned(tetrahedra + header.tetrahedra * sizeof(array<uint, 4>));
+		boundaries = aligned(conditions + header.conditions * sizeof(uint));
+		recessions = aligned(boundaries + header.boundaries * sizeof(BoundaryRecord));
+		descriptions = aligned(recessions + header.nodes * recessionValues * sizeof(double));
+		size = descriptions + header.descriptions;
 	}
 };
 
-// this function writes a mtl texture file to display the mesh in 3D
-// contains 3 materials
-// 1. grey and opaque
-// 2. grey and transparent
-// 3. red and opaque
-// for some reasons QT3D doesn't render transparency.
-void Material() {
-	auto filename = "mesh.mtl";
-	// return if file already exists
-	ifstream fileExist(filename);
-	if (fileExist.good())
-		return;
+// read only view of a whole file, memory mapped when available
+class MappedFile {
+public:
+	const char *data = nullptr;
+	uint64_t size = 0;
+
+	MappedFile(const string &filepath) {
+#ifdef _WIN32
+		ifstream file(filepath, ios::binary);
+		if (!file.good())
+			throw std::invalid_argument("Unable to open mesh file " + filepath);
+		buffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+		data = buffer.data();
+		size = buffer.size();
+#else
+		descriptor = open(filepath.c_str(), O_RDONLY);
+		struct stat status;
+		if (descriptor < 0 || fstat(descriptor, &status) != 0) {
+			if (descriptor >= 0)
+				close(descriptor);
+			throw std::invalid_argument("Unable to open mesh file " + filepath);
+		}
+		size = status.st_size;
+		if (size == 0)
+			return;
+		auto address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		if (address == MAP_FAILED) {
+			close(descriptor);
+			throw std::invalid_argument("Unable to map mesh file " + filepath);
+		}
+		madvise(address, size, MADV_SEQUENTIAL);
+		data = static_cast<const char *>(address);
+#endif
+	}
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+	~MappedFile() {
+#ifndef _WIN32
+		if (data)
+			munmap(const_cast<char *>(data), size);
+		if (descriptor >= 0)
+			close(descriptor);
+#endif
+	}
 
-	ofstream file(filename);
-	file << "# grey and transparent" << endl;
-	file << "newmtl transparent" << endl;
-	file << "Ns 250" << endl;
-	file << "Ka 1 1 1" << endl;
-	file << "Kd 0.8 0.8 0.8" << endl;
-	file << "Ks 0.5 0.5 0.5" << endl;
-	file << "Ke 0 0 0" << endl;
-	file << "Ni 1.45" << endl;
-	file << "d 0.5" << endl;
-	file << "illum 9" << endl;
-	file << endl;
-
-	file << "# grey and opaque" << endl;
-	file << "newmtl opaque" << endl;
-	file << "Ns 250" << endl;
-	file << "Ka 1 1 1" << endl;
-	file << "Kd 0.5 0.5 0.5" << endl;
-	file << "Ks 0.5 0.5 0.5" << endl;
-	file << "Ke 0 0 0" << endl;
-	file << "Ni 1.45" << endl;
-	file << "d 1" << endl;
-	file << "illum 2" << endl;
-	file << endl;
-
-	file << "# red and opaque" << endl;
-	file << "newmtl red" << endl;
-	file << "Ns 250" << endl;
-	file << "Ka 1 1 1" << endl;
-	file << "Kd 1 0 0" << endl;
-	file << "Ks 0.5 0.5 0.5" << endl;
-	file << "Ke 0 0 0" << endl;
-	file << "Ni 1.45" << endl;
-	file << "d 1" << endl;
-	file << "illum 2" << endl;
-	file << endl;
+private:
+#ifdef _WIN32
+	vector<char> buffer;
+#else
+	int descriptor = -1;
+#endif
 };
 
-void Boundary() {
-	ofstream file("boundary.obj");
-	file << "# boundary" << endl;
-	file << "mtllib mesh.mtl" << endl;
-	file << "usemtl transparent" << endl;
-	// write vertices
-	for (uint i = 0; i < mesh.nodes.size(); i++) {
-		file << "v " << mesh.nodes[i][0] << " " << mesh.nodes[i][1] << " " << mesh.nodes[i][2] << endl;
-	}
-	// write faces
-	for (auto &triangle : mesh.triangles)
-		file << "f " << triangle[0] << " " << triangle[1] << " " << triangle[2] << endl;
+template <typename T>
+void copySection(vector<T> &values, const MappedFile &file, uint64_t offset, uint64_t size) {
+	values.resize(size);
+	if (size > 0)
+		memcpy(values.data(), file.data + offset, size * sizeof(T));
 }
 
+bool isBinary(const std::string &filepath) {
+	ifstream file(filepath, ios::binary);
+	char fileMagic[sizeof(magic)];
+	if (!file.read(fileMagic, sizeof(fileMagic)))
+		return false;
+	return memcmp(fileMagic, magic, sizeof(magic)) == 0;
 }
+
+void readMesh(std::string &filepath) {
+	if (!littleEndian())
+		throw std::invalid_argument("Binary meshes are only supported on little-endian systems");
+
+	MappedFile file(filepath);
+	Header header;
+	if (file.size < sizeof(Header))
+		throw std::invalid_argument("Unable to read binary mesh. File too small");
+	memcpy(&header, file.data, sizeof(Header));
+	if (memcmp(header.magic, magic, sizeof(magic)) != 0)
+		throw std::invalid_argument("Unable to read binary mesh. Not a binary mesh file?");
+	if (header.version != version)
+		throw std::invalid_argument("Unable to read binary mesh. Unsupported version " + to_string(header.version));
+	if (header.conditions > header.triangles)
+		throw std::invalid_argument("Unable to read binary mesh. More triangle conditions than triangles");
+	const Layout layout(header);
+	if (file.size < layout.size)
+		throw std::invalid_argument("Unable to read binary mesh. File is truncated");
+
+	copySection(mesh.nodes, file, layout.nodes, header.nodes);
+	copySection(mesh.triangles, file, layout.triangles, header.triangles);
+	copySection(mesh.tetrahedra, file, layout.tetrahedra, header.tetrahedra);
+	copySection(triangleConditions, file, layout.conditions, header.conditions);
+	nodePermutation.clear();
+	tetrahedraPermutation.clear();
+
+	// node indices are checked as they are used to index the node arrays without bounds checking
+	auto validNode = [](uint node) { return node >= 1 && node <= mesh.nodes.size(); };
+	for (auto &tetrahedra : mesh.tetrahedra) {
+		if (!all_of(tetrahedra.begin(), tetrahedra.end(), validNode))
+			throw std::invalid_argument("Unable to read binary mesh. Node index out of range");
+	}
+	for (auto &triangle : mesh.triangles) {
+		if (!all_of(triangle.begin(), triangle.end(), validNode))
+			throw std::invalid_argument("Unable to read binary mesh. Node index out of range");
+	}
+
+	boundaries.clear();
+	for (uint index = 0; index < header.boundaries; ++index) {
+		BoundaryRecord record;
+		memcpy(&record, file.data + layout.boundaries + index * sizeof(BoundaryRecord), sizeof(BoundaryRecord));
+		if (record.tag < 1)
+			throw std::invalid_argument("Boundary tag must be greater than 0");
+		if (record.descriptionOffset + record.descriptionSize > header.descriptions)
+			throw std::invalid_argument("Unable to read binary mesh. Boundary description out of range");
+		auto description = string(file.data + layout.descriptions + record.descriptionOffset, record.descriptionSize);
+		boundaries.insert(pair<int, Boundary>(record.tag, Boundary{record.type, {record.value[0], record.value[1], record.value[2]}, description}));
+	}
+
+	recessionMatrix.clear();
+	anisotropic = header.flags & anisotropicFlag;
+	if (anisotropic) {
+		copySection(recessionAnisotropic, file, layout.recessions, header.nodes);
+		recession = vector<double>(mesh.nodes.size());
+	} else {
+		copySection(recession, file, layout.recessions, header.nodes);
+		recessionAnisotropic.clear();
+	}
+
+	Conditions::setNodeConditions();
+}
+
+template <typename T>
+void writeSection(ofstream &file, const vector<T> &values) {
+	file.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+	const auto padding = aligned(file.tellp()) - uint64_t(file.tellp());
+	const char zeros[8] = {};
+	file.write(zeros, padding);
+}
+
+void writeMesh(std::string &filepath) {
+	if (!littleEndian())
+		throw std::invalid_argument("Binary meshes are only supported on little-endian systems");
+
+	const auto nodes = Reorder::toOriginal(mesh.nodes, nodePermutation);
+	const auto triangles = Reorder::originalNodes(mesh.triangles);
+	const auto tetrahedra = Reorder::toOriginal(Reorder::originalNodes(mesh.tetrahedra), tetrahedraPermutation);
+
+	vector<BoundaryRecord> records;
+	string descriptions;
+	for (auto &[tag, boundary] : boundaries) {
+		if (tag == 0)
+			continue;
+		records.push_back({tag, boundary.type, {boundary.value[0], boundary.value[1], boundary.value[2]}, descriptions.size(), boundary.description.size()});
+		descriptions += boundary.description;
+	}
+
+	Header header;
+	memcpy(header.magic, magic, sizeof(magic));
+	header.version = version;
+	header.flags = anisotropic ? anisotropicFlag : 0;
+	header.nodes = nodes.size();
+	header.triangles = triangles.size();
+	header.tetrahedra = tetrahedra.size();
+	header.conditions = triangleConditions.size();
+	header.boundaries = records.size();
+	header.descriptions = descriptions.size();
+
+	ofstream file(filepath, ios::binary | ios::trunc);
+	if (!file.good())
+		throw std::invalid_argument("Unable to write binary mesh " + filepath);
+	file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+	writeSection(file, nodes);
+	writeSection(file, triangles);
+	writeSection(file, tetrahedra);
+	writeSection(file, triangleConditions);
+	writeSection(file, records);
+	if (anisotropic)
+		writeSection(file, Reorder::toOriginal(recessionAnisotropic, nodePermutation));
+	else
+		writeSection(file, Reorder::toOriginal(recession, nodePermutation));
+	file.write(descriptions.data(), descriptions.size());
+	if (!file.good())
+		throw std::invalid_argument("Unable to write binary mesh " + filepath);
+}
+
+bool isResults(const std::string &filepath) {
+	return filepath.size() >= resultsExtension.size() &&
+	       filepath.compare(filepath.size() - resultsExtension.size(), resultsExtension.size(), resultsExtension) == 0;
+}
+
+void writeResults(std::string &filepath) {
+	if (!littleEndian())
+		throw std::invalid_argument("Binary results are only supported on little-endian systems");
+
+	auto gradient = vector<array<double, 3>>(mesh.tetrahedra.size());
+	for (uint tetrahedra = 0; tetrahedra < mesh.tetrahedra.size(); ++tetrahedra)
+		gradient[tetrahedra] = computationData.tetrahedraGradient(tetrahedra);
+
+	ResultsHeader header;
+	memcpy(header.magic, resultsMagic, sizeof(resultsMagic));
+	header.version = resultsVersion;
+	header.iterations = currentIter;
+	header.nodes = mesh.nodes.size();
+	header.tetrahedra = mesh.tetrahedra.size();
+	header.hash = GeometryCache::meshFileHash();
+	header.timeStep = timeStep;
+	header.timeTotal = timeTotal;
+
+	ofstream file(filepath, ios::binary | ios::trunc);
+	if (!file.good())
+		throw std::invalid_argument("Unable to write binary results " + filepath);
+	file.write(reinterpret_cast<const char *>(&header), sizeof(ResultsHeader));
+	writeSection(file, Reorder::toOriginal(computationData.uVertex, nodePermutation));
+	writeSection(file, Reorder::toOriginal(computationData.flux[0], nodePermutation));
+	writeSection(file, Reorder::toOriginal(computationData.flux[1], nodePermutation));
+	writeSection(file, Reorder::toOriginal(gradient, tetrahedraPermutation));
+	if (!file.good())
+		throw std::invalid_argument("Unable to write binary results " + filepath);
+}
+} //}}}
+
+namespace GeometryCache { //{{{
+const char magic[8] = {'B', 'B', '3', 'D', 'G', 'E', 'O', 'M'};
+// increase when the geometry streams change
+const uint32_t version = 2;
+
+struct Header {
+	char magic[8];
+	uint32_t version;
+	uint32_t streams;
+	uint64_t hash;
+	uint64_t nodes;
+	uint64_t tetrahedra;
+	double maxHeight;
+};
+
+// FNV-1a over 64 bit words
+uint64_t hashWords(uint64_t hash, const void *data, size_t size) {
+	const auto *bytes = static_cast<const char *>(data);
+	for (size_t offset = 0; offset < size; offset += sizeof(uint64_t)) {
+		uint64_t word = 0;
+		memcpy(&word, bytes + offset, min(sizeof(uint64_t), size - offset));
+		hash = (hash ^ word) * 0x100000001b3;
+	}
+	return hash;
+}
+
+uint64_t meshHash(const std::vector<std::array<double, 3>> &nodes, const std::vector<std::array<uint, 4>> &tetrahedra) {
+	uint64_t hash = 0xcbf29ce484222325;
+	const uint64_t sizes[2] = {nodes.size(), tetrahedra.size()};
+	hash = hashWords(hash, sizes, sizeof(sizes));
+	hash = hashWords(hash, nodes.data(), nodes.size() * sizeof(nodes[0]));
+	hash = hashWords(hash, tetrahedra.data(), tetrahedra.size() * sizeof(tetrahedra[0]));
+	// 0 means no geometry
+	return hash == 0 ? 1 : hash;
+}
+
+uint64_t meshHash() {
+	return meshHash(mesh.nodes, mesh.tetrahedra);
+}
+
+uint64_t meshFileHash() {
+	if (nodePermutation.empty())
+		return meshHash();
+	return meshHash(Reorder::toOriginal(mesh.nodes, nodePermutation),
+	                Reorder::toOriginal(Reorder::originalNodes(mesh.tetrahedra), tetrahedraPermutation));
+}
+
+std::string path(const std::string &meshPath, bool reordered) {
+	auto extension = meshPath.rfind('.');
+	if (extension == string::npos || meshPath.find_first_of("/\\", extension) != string::npos)
+		extension = meshPath.size();
+	return meshPath.substr(0, extension) + (reordered ? ".reordered.geom" : ".geom");
+}
+
+bool read(const std::string &filepath, uint64_t hash) {
+	ifstream file(filepath, ios::binary);
+	Header header;
+	if (!file.read(reinterpret_cast<char *>(&header), sizeof(Header)))
+		return false;
+
+	auto streams = TetrahedraGeometry().streams();
+	if (memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version || header.streams != streams.size() ||
+	    header.hash != hash || header.nodes != mesh.nodes.size() || header.tetrahedra != mesh.tetrahedra.size())
+		return false;
+
+	auto geometry = TetrahedraGeometry(mesh.tetrahedra.size());
+	auto totals = vector<double>(mesh.nodes.size());
+	auto heights = vector<double>(mesh.nodes.size());
+	for (auto *stream : geometry.streams())
+		file.read(reinterpret_cast<char *>(stream->data()), stream->size() * sizeof(double));
+	file.read(reinterpret_cast<char *>(totals.data()), totals.size() * sizeof(double));
+	file.read(reinterpret_cast<char *>(heights.data()), heights.size() * sizeof(double));
+	if (!file)
+		return false;
+
+	tetrahedraGeometry = move(geometry);
+	angleTotal = move(totals);
+	nodeHeight = move(heights);
+	maxHeight = header.maxHeight;
+	return true;
+}
+
+void write(const std::string &filepath, uint64_t hash) {
+	auto streams = tetrahedraGeometry.streams();
+	Header header;
+	memcpy(header.magic, magic, sizeof(magic));
+	header.version = version;
+	header.streams = streams.size();
+	header.hash = hash;
+	header.nodes = mesh.nodes.size();
+	header.tetrahedra = mesh.tetrahedra.size();
+	header.maxHeight = maxHeight;
+
+	// written next to the cache and renamed, so another run of the same mesh never reads a partial file
+	const auto temporary = filepath + ".tmp";
+	{
+		ofstream file(temporary, ios::binary | ios::trunc);
+		file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+		for (auto *stream : streams)
+			file.write(reinterpret_cast<const char *>(stream->data()), stream->size() * sizeof(double));
+		file.write(reinterpret_cast<const char *>(angleTotal.data()), angleTotal.size() * sizeof(double));
+		file.write(reinterpret_cast<const char *>(nodeHeight.data()), nodeHeight.size() * sizeof(double));
+		if (!file.good())
+			throw std::invalid_argument("Unable to write geometry cache " + temporary);
+	}
+	error_code error;
+	filesystem::rename(temporary, filepath, error);
+	if (error)
+		throw std::invalid_argument("Unable to replace geometry cache " + filepath);
+}
+} //}}}
@@ -0,0 +1,83 @@
+#include <QByteArray>
+#include <cmath>
+#include <cstring>
+
+#include <src/headers/isosurfaceGeometry.h>
+#include <src/headers/operations.h>
+
+using namespace std;
+using namespace Qt3DGeometry;
+using namespace Vectors;
+
+// position and normal of each vertex, interleaved
+constexpr uint vertexFloats = 6;
+
+IsosurfaceGeometry::IsosurfaceGeometry(Qt3DCore::QNode *parent) : QGeometry(parent) {
+	vertexBuffer = new QBuffer(this);
+	indexBuffer = new QBuffer(this);
+
+	positionAttribute = new QAttribute(this);
+	positionAttribute->setName(QAttribute::defaultPositionAttributeName());
+	positionAttribute->setAttributeType(QAttribute::VertexAttribute);
+	positionAttribute->setVertexBaseType(QAttribute::Float);
+	positionAttribute->setVertexSize(3);
+	positionAttribute->setByteStride(vertexFloats * sizeof(float));
+	positionAttribute->setBuffer(vertexBuffer);
+	addAttribute(positionAttribute);
+
+	normalAttribute = new QAttribute(this);
+	normalAttribute->setName(QAttribute::defaultNormalAttributeName());
+	normalAttribute->setAttributeType(QAttribute::VertexAttribute);
+	normalAttribute->setVertexBaseType(QAttribute::Float);
+	normalAttribute->setVertexSize(3);
+	normalAttribute->setByteOffset(3 * sizeof(float));
+	normalAttribute->setByteStride(vertexFloats * sizeof(float));
+	normalAttribute->setBuffer(vertexBuffer);
+	addAttribute(normalAttribute);
+
+	indexAttribute = new QAttribute(this);
+	indexAttribute->setAttributeType(QAttribute::IndexAttribute);
+	indexAttribute->setVertexBaseType(QAttribute::UnsignedInt);
+	indexAttribute->setBuffer(indexBuffer);
+	addAttribute(indexAttribute);
+}
+
+void IsosurfaceGeometry::setSurface(const IsocontourData &data) {
+	// the y and z axis are swapped, so the z axis of the mesh points upwards in the view
+	auto position = [&data](uint node) -> array<double, 3> {
+		return {data.nodes[node][0], data.nodes[node][2], data.nodes[node][1]};
+	};
+
+	// smooth normals, the sum of the normals of the adjacent triangles weighted by their area
+	auto normals = vector<array<double, 3>>(data.nodes.size());
+	for (auto &triangle : data.triangles) {
+		auto origin = position(triangle[0]);
+		auto normal = crossProduct(subtraction(position(triangle[1]), origin), subtraction(position(triangle[2]), origin));
+		for (auto node : triangle) {
+			for (uint i = 0; i < 3; ++i)
+				normals[node][i] += normal[i];
+		}
+	}
+
+	QByteArray vertices(data.nodes.size() * vertexFloats * sizeof(float), Qt::Uninitialized);
+	auto vertex = reinterpret_cast<float *>(vertices.data());
+	for (uint node = 0; node < data.nodes.size(); ++node, vertex += vertexFloats) {
+		auto coordinates = position(node);
+		auto length = magnitude(normals[node]);
+		for (uint i = 0; i < 3; ++i) {
+			vertex[i] = coordinates[i];
+			vertex[i + 3] = length > 0 ? normals[node][i] / length : 0;
+		}
+	}
+
+	static_assert(sizeof(data.triangles[0]) == 3 * sizeof(uint), "Triangles must be contiguous indices");
+	QByteArray indices(data.triangles.size() * sizeof(data.triangles[0]), Qt::Uninitialized);
+	if (!data.triangles.empty())
+		memcpy(indices.data(), data.triangles.data(), indices.size());
+
+	vertexBuffer->setData(vertices);
+	indexBuffer->setData(indices);
+	positionAttribute->setCount(data.nodes.size());
+	normalAttribute->setCount(data.nodes.size());
+	indexAttribute->setCount(data.triangles.size() * 3);
+}
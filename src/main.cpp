@@ -1,12 +1,12 @@
 #include <QApplication>
-#include <QDir>
 #include <QFontDatabase>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
-#include <QStandardPaths>
+#include <QtQml>
 
 #include <src/headers/globals.h>
 #include <src/headers/interface.h>
+#include <src/headers/isosurfaceGeometry.h>
 
 int main(int argc, char *argv[]) {
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -14,6 +14,7 @@ int main(int argc, char *argv[]) {
 #endif
 	QApplication app(argc, argv);
 
+	qmlRegisterType<IsosurfaceGeometry>("Burnback", 1, 0, "IsosurfaceGeometry");
 	QQmlApplicationEngine engine;
 
 	// Set the context property to access the class from QML
@@ -39,15 +40,5 @@ int main(int argc, char *argv[]) {
 	QObject *output = root->findChild<QObject *>("output");
 	output->setProperty("font", fixedFont);
 
-	// create temporary directory path to store isosurfaces
-	tmpDir = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
-	if (tmpDir == "") {
-		tmpDir = QDir::currentPath();
-	}
-	if (!tmpDir.endsWith("/")) {
-		tmpDir += "/";
-	}
-	tmpDir += "burnback-3d/";
-
 	return app.exec();
 }
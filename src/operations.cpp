@@ -1,9 +1,16 @@
 #ifdef _WIN32
 #define _USE_MATH_DEFINES
 #endif
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
 #include <src/headers/globals.h>
 #include <src/headers/operations.h>
+#include <src/headers/parallel.h>
+#include <src/headers/simd.h>
 
 #include <iostream>
 
@@ -13,10 +20,8 @@ using namespace Vectors;
 namespace Geometry { //{{{
 void computeGeometry() {
 	for (uint tetrahedra = 0; tetrahedra < mesh.tetrahedra.size(); ++tetrahedra) {
-		auto &solidAngle = tetrahedraGeometry.solidAngle[tetrahedra];
-		auto &normal = tetrahedraGeometry.normal[tetrahedra];
-		auto &area = tetrahedraGeometry.triangleArea[tetrahedra];
 		auto &jacobi = tetrahedraGeometry.jacobiDeterminant[tetrahedra];
+		auto height = numeric_limits<double>::infinity();
 
 		for (uint vertex = 0; vertex < 4; ++vertex) {
 			const auto nodeO = mesh.tetrahedra[tetrahedra][vertex] - 1;
@@ -43,13 +48,14 @@ void computeGeometry() {
 			const auto sOBCA = scalarProduct(OB, OC) * magnitudeOA;
 			const auto sOCAB = scalarProduct(OC, OA) * magnitudeOB;
 
-			solidAngle[vertex] = abs(2 * atan2(tripleProduct, sOABC + sOBCA + sOCAB + magnitudeOABC));
+			auto &solidAngle = tetrahedraGeometry.solidAngle[vertex][tetrahedra];
+			solidAngle = abs(2 * atan2(tripleProduct, sOABC + sOBCA + sOCAB + magnitudeOABC));
 			// cpp's atan2 returns values between -pi and pi,
 			// solid angle is always positive, so we need to add 2pi to negative values
-			// if (solidAngle[vertex] < 0)
-			// 	solidAngle[vertex] *= -1;
-			angleTotal[nodeO] += solidAngle[vertex];
-			// solidAngle[vertex] += 2 * M_PI;
+			// if (solidAngle < 0)
+			// 	solidAngle *= -1;
+			angleTotal[nodeO] += solidAngle;
+			// solidAngle += 2 * M_PI;
 
 			// Calculating area and normal vector of the intersection with a unit sphere
 			const auto uOA = normalization(OA);
@@ -60,148 +66,598 @@ void computeGeometry() {
 			const auto uAC = subtraction(uOC, uOA);
 
 			auto _normal = crossProduct(uAB, uAC);
-			normal[vertex] = normalization(_normal);
+			auto normal = normalization(_normal);
 			// Check if normal vector is pointing outwards (going away from O)
-			if (scalarProduct(normal[vertex], OA) < 0)
-				normal[vertex] = multiplication(normal[vertex], -1);
-			area[vertex] = magnitude(_normal) / 2;
+			if (scalarProduct(normal, OA) < 0)
+				normal = multiplication(normal, -1);
+			for (uint component = 0; component < 3; ++component)
+				tetrahedraGeometry.normal[vertex][component][tetrahedra] = normal[component];
+			tetrahedraGeometry.triangleArea[vertex][tetrahedra] = magnitude(_normal) / 2;
 
 			// Calculating jacobi determinant and time step
 			auto oppositeTriangleArea = magnitude((crossProduct(OA, OB))) / 2;
 
-			if (vertex == 0)
+			if (vertex == 0) {
 				jacobi = abs(scalarProduct(crossProduct(OA, OB), OC));
 
-			if (tetrahedra == 0)
-				maxHeight = jacobi / (oppositeTriangleArea * 2);
-			else if (timeStep > jacobi / (oppositeTriangleArea * 2))
-				maxHeight = jacobi / (oppositeTriangleArea * 2);
+				// columns of the inverse of the matrix with rows OA, OB, OC, scaled by its determinant,
+				// the determinant is taken in absolute value as in the gradient computed from the coordinates
+				const array<array<double, 3>, 3> adjugate = {crossProduct(OB, OC), crossProduct(OC, OA), crossProduct(OA, OB)};
+				for (uint component = 0; component < 3; ++component) {
+					auto &gradientOperator = tetrahedraGeometry.gradientOperator;
+					gradientOperator[0][component][tetrahedra] = 0;
+					for (uint column = 0; column < 3; ++column) {
+						gradientOperator[column + 1][component][tetrahedra] = adjugate[column][component] / jacobi;
+						gradientOperator[0][component][tetrahedra] -= adjugate[column][component] / jacobi;
+					}
+				}
+			}
+
+			// height of C over the face OAB, the smallest one limits the time step of the tetrahedra
+			height = min(height, jacobi / (oppositeTriangleArea * 2));
 		}
+		for (auto &node : mesh.tetrahedra[tetrahedra])
+			nodeHeight[node - 1] = min(nodeHeight[node - 1], height / 6);
 	}
 	for (uint tetrahedra = 0; tetrahedra < mesh.tetrahedra.size(); ++tetrahedra) {
 		for (uint vertex = 0; vertex < 4; ++vertex) {
 			const auto &node = mesh.tetrahedra[tetrahedra][vertex] - 1;
-			tetrahedraGeometry.vertexWeight[tetrahedra][vertex] = tetrahedraGeometry.solidAngle[tetrahedra][vertex] / angleTotal[node];
+			tetrahedraGeometry.vertexWeight[vertex][tetrahedra] = tetrahedraGeometry.solidAngle[vertex][tetrahedra] / angleTotal[node];
 		}
 	}
-	maxHeight /= 6;
+	maxHeight = *min_element(nodeHeight.begin(), nodeHeight.end());
 }
 }
 //}}}
 
 namespace Tetrahedra { //{{{
-void computeMeanGradient() {
+// calls the kernel for every tetrahedra, which may add to the values of its nodes
+// in parallel, tetrahedra of the same color are processed concurrently as they do not share any node
+template <typename Kernel>
+void scatter(const Kernel &kernel) {
+	if (Parallel::threads() == 1 || tetrahedraColors.empty()) {
+		for (uint tetrahedra = 0; tetrahedra < mesh.tetrahedra.size(); ++tetrahedra)
+			kernel(tetrahedra);
+		return;
+	}
+	for (auto &color : tetrahedraColors) {
+		Parallel::forRange(color.size(), [&](uint begin, uint end, uint) {
+			for (auto index = begin; index < end; ++index)
+				kernel(color[index]);
+		});
+	}
+}
+
+// greedy coloring of the tetrahedra, so that tetrahedra with the same color do not share any node
+void computeColoring() {
+	tetrahedraColors.clear();
+	vector<vector<uint>> nodeColors(mesh.nodes.size());
+	vector<bool> usedColors;
 	for (uint tetrahedra = 0; tetrahedra < mesh.tetrahedra.size(); ++tetrahedra) {
-		const auto nodeO = mesh.tetrahedra[tetrahedra][0] - 1;
-		const auto nodeA = mesh.tetrahedra[tetrahedra][1] - 1;
-		const auto nodeB = mesh.tetrahedra[tetrahedra][2] - 1;
-		const auto nodeC = mesh.tetrahedra[tetrahedra][3] - 1;
-		const auto uOABC = array<double, 4>{
-		    computationData.uVertex[nodeO],
-		    computationData.uVertex[nodeA],
-		    computationData.uVertex[nodeB],
-		    computationData.uVertex[nodeC]};
-		const auto &vertexOCoord = mesh.nodes[nodeO];
-		const auto &vertexACoord = mesh.nodes[nodeA];
-		const auto &vertexBCoord = mesh.nodes[nodeB];
-		const auto &vertexCCoord = mesh.nodes[nodeC];
-		auto coordinates = array<array<double, 3>, 4>{{
-		    {vertexOCoord[0], vertexOCoord[1], vertexOCoord[2]},
-		    {vertexACoord[0], vertexACoord[1], vertexACoord[2]},
-		    {vertexBCoord[0], vertexBCoord[1], vertexBCoord[2]},
-		    {vertexCCoord[0], vertexCCoord[1], vertexCCoord[2]},
-		}};
+		usedColors.assign(tetrahedraColors.size() + 1, false);
+		for (auto &node : mesh.tetrahedra[tetrahedra]) {
+			for (auto &color : nodeColors[node - 1])
+				usedColors[color] = true;
+		}
+		uint color = find(usedColors.begin(), usedColors.end(), false) - usedColors.begin();
+		if (color == tetrahedraColors.size())
+			tetrahedraColors.emplace_back();
+		tetrahedraColors[color].push_back(tetrahedra);
+		for (auto &node : mesh.tetrahedra[tetrahedra])
+			nodeColors[node - 1].push_back(color);
+	}
+}
+
+// scalar kernels of a single tetrahedra, also used for the remainder of the vectorized loops
+void meanGradient(uint tetrahedra) {
+	const auto nodeO = mesh.tetrahedra[tetrahedra][0] - 1;
+	const auto nodeA = mesh.tetrahedra[tetrahedra][1] - 1;
+	const auto nodeB = mesh.tetrahedra[tetrahedra][2] - 1;
+	const auto nodeC = mesh.tetrahedra[tetrahedra][3] - 1;
+	const auto uOABC = array<double, 4>{
+	    computationData.uVertex[nodeO],
+	    computationData.uVertex[nodeA],
+	    computationData.uVertex[nodeB],
+	    computationData.uVertex[nodeC]};
+	const auto &vertexOCoord = mesh.nodes[nodeO];
+	const auto &vertexACoord = mesh.nodes[nodeA];
+	const auto &vertexBCoord = mesh.nodes[nodeB];
+	const auto &vertexCCoord = mesh.nodes[nodeC];
+	auto coordinates = array<array<double, 3>, 4>{{
+	    {vertexOCoord[0], vertexOCoord[1], vertexOCoord[2]},
+	    {vertexACoord[0], vertexACoord[1], vertexACoord[2]},
+	    {vertexBCoord[0], vertexBCoord[1], vertexBCoord[2]},
+	    {vertexCCoord[0], vertexCCoord[1], vertexCCoord[2]},
+	}};
+
+	for (int index = 0; index < 3; ++index) {
+		auto sCoord = coordinates;
+		for (int vertex = 0; vertex < 4; ++vertex)
+			sCoord[vertex][index] = uOABC[vertex];
+		auto r12 = subtraction(sCoord[1], sCoord[0]);
+		auto r13 = subtraction(sCoord[2], sCoord[0]);
+		auto r14 = subtraction(sCoord[3], sCoord[0]);
+		computationData.gradient[index][tetrahedra] = scalarProduct(crossProduct(r12, r13), r14) / tetrahedraGeometry.jacobiDeterminant[tetrahedra];
+	}
+}
+
+void storedGradient(uint tetrahedra) {
+	const auto &gradientOperator = tetrahedraGeometry.gradientOperator;
+	array<double, 3> gradient = {0, 0, 0};
+	for (uint vertex = 0; vertex < 4; ++vertex) {
+		const auto &u = computationData.uVertex[mesh.tetrahedra[tetrahedra][vertex] - 1];
+		for (uint component = 0; component < 3; ++component)
+			gradient[component] += gradientOperator[vertex][component][tetrahedra] * u;
+	}
+	for (uint component = 0; component < 3; ++component)
+		computationData.gradient[component][tetrahedra] = gradient[component];
+}
+
+void diffusiveContribution(uint tetrahedra) {
+	const auto gradient = computationData.tetrahedraGradient(tetrahedra);
+	for (uint vertex = 0; vertex < 4; ++vertex) {
+		const auto node = mesh.tetrahedra[tetrahedra][vertex] - 1;
+		const auto vertexGradient = computationData.nodeGradient(node);
+		const auto normal = array<double, 3>{
+		    tetrahedraGeometry.normal[vertex][0][tetrahedra],
+		    tetrahedraGeometry.normal[vertex][1][tetrahedra],
+		    tetrahedraGeometry.normal[vertex][2][tetrahedra]};
+		const auto &weight = tetrahedraGeometry.vertexWeight[vertex][tetrahedra];
+		auto subtractedGradient = subtraction(gradient, vertexGradient);
+		computationData.diffusiveFlux[vertex][tetrahedra] = scalarProduct(subtractedGradient, normal) * weight;
+	}
+}
 
-		auto &gradient = computationData.gradient[tetrahedra];
-		for (int index = 0; index < 3; ++index) {
-			auto sCoord = coordinates;
-			for (int vertex = 0; vertex < 4; ++vertex)
-				sCoord[vertex][index] = uOABC[vertex];
-			auto r12 = subtraction(sCoord[1], sCoord[0]);
-			auto r13 = subtraction(sCoord[2], sCoord[0]);
-			auto r14 = subtraction(sCoord[3], sCoord[0]);
-			gradient[index] = scalarProduct(crossProduct(r12, r13), r14) / tetrahedraGeometry.jacobiDeterminant[tetrahedra];
+#ifdef SIMD_ENABLED
+// vectorized kernels of Simd::width consecutive tetrahedra
+void meanGradientSimd(uint tetrahedra) {
+	using namespace Simd;
+	const auto *tetrahedraNodes = &mesh.tetrahedra[tetrahedra];
+	const auto *coordinates = mesh.nodes[0].data();
+
+	array<Pack, 4> uOABC;
+	array<array<Pack, 3>, 4> vertexCoord;
+	for (uint vertex = 0; vertex < 4; ++vertex) {
+		uOABC[vertex] = gather(computationData.uVertex.data(), nodeIndex(tetrahedraNodes, vertex, 1));
+		const auto coordinatesIndex = nodeIndex(tetrahedraNodes, vertex, 3);
+		for (uint component = 0; component < 3; ++component)
+			vertexCoord[vertex][component] = gather(coordinates + component, coordinatesIndex);
+	}
+
+	const auto jacobi = load(&tetrahedraGeometry.jacobiDeterminant[tetrahedra]);
+	for (uint index = 0; index < 3; ++index) {
+		array<array<Pack, 3>, 3> r;
+		for (uint vertex = 1; vertex < 4; ++vertex) {
+			for (uint component = 0; component < 3; ++component) {
+				if (component == index)
+					r[vertex - 1][component] = uOABC[vertex] - uOABC[0];
+				else
+					r[vertex - 1][component] = vertexCoord[vertex][component] - vertexCoord[0][component];
+			}
+		}
+		const auto cross = crossProduct(r[0], r[1]);
+		const auto triple = cross[0] * r[2][0] + cross[1] * r[2][1] + cross[2] * r[2][2];
+		store(&computationData.gradient[index][tetrahedra], triple / jacobi);
+	}
+}
+
+void storedGradientSimd(uint tetrahedra) {
+	using namespace Simd;
+	const auto *tetrahedraNodes = &mesh.tetrahedra[tetrahedra];
+	const auto &gradientOperator = tetrahedraGeometry.gradientOperator;
+
+	array<Pack, 3> gradient = {broadcast(0), broadcast(0), broadcast(0)};
+	for (uint vertex = 0; vertex < 4; ++vertex) {
+		const auto u = gather(computationData.uVertex.data(), nodeIndex(tetrahedraNodes, vertex, 1));
+		for (uint component = 0; component < 3; ++component)
+			gradient[component] = gradient[component] + load(&gradientOperator[vertex][component][tetrahedra]) * u;
+	}
+	for (uint component = 0; component < 3; ++component)
+		store(&computationData.gradient[component][tetrahedra], gradient[component]);
+}
+
+void diffusiveContributionSimd(uint tetrahedra) {
+	using namespace Simd;
+	const auto *tetrahedraNodes = &mesh.tetrahedra[tetrahedra];
+
+	array<Pack, 3> gradient;
+	for (uint component = 0; component < 3; ++component)
+		gradient[component] = load(&computationData.gradient[component][tetrahedra]);
+
+	for (uint vertex = 0; vertex < 4; ++vertex) {
+		const auto node = nodeIndex(tetrahedraNodes, vertex, 1);
+		auto flux = broadcast(0);
+		for (uint component = 0; component < 3; ++component) {
+			const auto subtractedGradient = gradient[component] - gather(computationData.vertexGradient[component].data(), node);
+			flux = flux + subtractedGradient * load(&tetrahedraGeometry.normal[vertex][component][tetrahedra]);
 		}
+		store(&computationData.diffusiveFlux[vertex][tetrahedra], flux * load(&tetrahedraGeometry.vertexWeight[vertex][tetrahedra]));
 	}
 }
+#endif
+
+void computeMeanGradient() {
+	Parallel::forRange(mesh.tetrahedra.size(), [](uint begin, uint end, uint) {
+		auto tetrahedra = begin;
+		if (input.storedGradient) {
+#ifdef SIMD_ENABLED
+			for (; tetrahedra + Simd::width <= end; tetrahedra += Simd::width)
+				storedGradientSimd(tetrahedra);
+#endif
+			for (; tetrahedra < end; ++tetrahedra)
+				storedGradient(tetrahedra);
+			return;
+		}
+#ifdef SIMD_ENABLED
+		for (; tetrahedra + Simd::width <= end; tetrahedra += Simd::width)
+			meanGradientSimd(tetrahedra);
+#endif
+		for (; tetrahedra < end; ++tetrahedra)
+			meanGradient(tetrahedra);
+	});
+}
+// scalar kernels only, the tetrahedra of the list are not consecutive
+void computeMeanGradient(const vector<uint> &tetrahedra) {
+	Parallel::forRange(tetrahedra.size(), [&](uint begin, uint end, uint) {
+		for (uint index = begin; index < end; ++index) {
+			if (input.storedGradient)
+				storedGradient(tetrahedra[index]);
+			else
+				meanGradient(tetrahedra[index]);
+		}
+	});
+}
 void computeVertexGradient() {
-	computationData.vertexGradient = vector<array<double, 3>>(mesh.nodes.size());
+	for (auto &component : computationData.vertexGradient)
+		fill(component.begin(), component.end(), 0.0);
 
-	for (uint tetrahedra = 0; tetrahedra < mesh.tetrahedra.size(); ++tetrahedra) {
-		const auto &gradient = computationData.gradient[tetrahedra];
+	scatter([](uint tetrahedra) {
 		for (uint vertex = 0; vertex < 4; ++vertex) {
 			const auto node = mesh.tetrahedra[tetrahedra][vertex] - 1;
-			const auto &weight = tetrahedraGeometry.vertexWeight[tetrahedra][vertex];
-			auto &vertexGradient = computationData.vertexGradient[node];
-			vertexGradient = summation(vertexGradient, multiplication(gradient, weight));
+			const auto &weight = tetrahedraGeometry.vertexWeight[vertex][tetrahedra];
+			for (uint component = 0; component < 3; ++component)
+				computationData.vertexGradient[component][node] += computationData.gradient[component][tetrahedra] * weight;
 		}
-	}
+	});
+}
+
+// contribution of each tetrahedra to the diffusive flux of its vertices, added to the nodes by the flux kernels
+void computeDiffusiveContribution() {
+	Parallel::forRange(mesh.tetrahedra.size(), [](uint begin, uint end, uint) {
+		auto tetrahedra = begin;
+#ifdef SIMD_ENABLED
+		for (; tetrahedra + Simd::width <= end; tetrahedra += Simd::width)
+			diffusiveContributionSimd(tetrahedra);
+#endif
+		for (; tetrahedra < end; ++tetrahedra)
+			diffusiveContribution(tetrahedra);
+	});
 }
 
 void computeDiffusiveFlux() {
-	computationData.flux.fill(vector<double>(mesh.nodes.size()));
+	fill(computationData.flux[1].begin(), computationData.flux[1].end(), 0.0);
 
-	for (uint tetrahedra = 0; tetrahedra < mesh.tetrahedra.size(); ++tetrahedra) {
-		const auto &gradient = computationData.gradient[tetrahedra];
-		uint vertexIndex = 0;
-		for (auto &_node : mesh.tetrahedra[tetrahedra]) {
-			const auto node = _node - 1;
-			auto &vertexGradient = computationData.vertexGradient[node];
-
-			const auto &normal = tetrahedraGeometry.normal[tetrahedra][vertexIndex];
-			const auto &weight = tetrahedraGeometry.vertexWeight[tetrahedra][vertexIndex];
-			auto &flux = computationData.flux[1][node];
-			auto subtractedGradient = subtraction(gradient, vertexGradient);
-			flux += scalarProduct(subtractedGradient, normal) * weight;
-			vertexIndex++;
+	scatter([](uint tetrahedra) {
+		for (uint vertex = 0; vertex < 4; ++vertex) {
+			const auto node = mesh.tetrahedra[tetrahedra][vertex] - 1;
+			computationData.flux[1][node] += computationData.diffusiveFlux[vertex][tetrahedra];
 		}
-	}
+	});
 }
 }
 //}}}
 
 namespace Nodes { //{{{
+void computeIncidence() {
+	auto &offset = nodeIncidence.offset;
+	auto &entries = nodeIncidence.entries;
+	offset = vector<uint>(mesh.nodes.size() + 1);
+	for (auto &tetrahedra : mesh.tetrahedra) {
+		for (auto &node : tetrahedra)
+			offset[node]++;
+	}
+	for (uint node = 0; node < mesh.nodes.size(); ++node)
+		offset[node + 1] += offset[node];
+
+	// filled in tetrahedra order, so gathering adds in the same order as the serial scatter
+	auto position = vector<uint>(offset.begin(), offset.end() - 1);
+	entries = vector<uint>(offset.back());
+	for (uint tetrahedra = 0; tetrahedra < mesh.tetrahedra.size(); ++tetrahedra) {
+		for (uint vertex = 0; vertex < 4; ++vertex) {
+			const auto node = mesh.tetrahedra[tetrahedra][vertex] - 1;
+			entries[position[node]++] = tetrahedra * 4 + vertex;
+		}
+	}
+}
+
+void computeNeighbours(vector<uint> &offset, vector<uint> &neighbours) {
+	offset = vector<uint>(1, 0);
+	neighbours.clear();
+	vector<uint> nodes;
+	for (uint node = 0; node < mesh.nodes.size(); ++node) {
+		nodes.clear();
+		for (auto entry = nodeIncidence.offset[node]; entry < nodeIncidence.offset[node + 1]; ++entry) {
+			for (auto &neighbour : mesh.tetrahedra[nodeIncidence.entries[entry] / 4]) {
+				if (neighbour - 1 != node)
+					nodes.push_back(neighbour - 1);
+			}
+		}
+		sort(nodes.begin(), nodes.end());
+		nodes.erase(unique(nodes.begin(), nodes.end()), nodes.end());
+		neighbours.insert(neighbours.end(), nodes.begin(), nodes.end());
+		offset.push_back(neighbours.size());
+	}
+}
+
+// gather versions of the tetrahedra kernels, each node reads from its incident tetrahedra
+void computeVertexGradient() {
+	Parallel::forRange(mesh.nodes.size(), [](uint begin, uint end, uint) {
+		for (uint node = begin; node < end; ++node) {
+			array<double, 3> vertexGradient = {0, 0, 0};
+			for (auto entry = nodeIncidence.offset[node]; entry < nodeIncidence.offset[node + 1]; ++entry) {
+				const auto tetrahedra = nodeIncidence.entries[entry] / 4;
+				const auto vertex = nodeIncidence.entries[entry] % 4;
+				const auto &weight = tetrahedraGeometry.vertexWeight[vertex][tetrahedra];
+				for (uint component = 0; component < 3; ++component)
+					vertexGradient[component] += computationData.gradient[component][tetrahedra] * weight;
+			}
+			computationData.setNodeGradient(node, vertexGradient);
+		}
+	});
+}
+
+void computeDiffusiveFlux() {
+	Parallel::forRange(mesh.nodes.size(), [](uint begin, uint end, uint) {
+		for (uint node = begin; node < end; ++node) {
+			auto flux = 0.0;
+			for (auto entry = nodeIncidence.offset[node]; entry < nodeIncidence.offset[node + 1]; ++entry) {
+				const auto tetrahedra = nodeIncidence.entries[entry] / 4;
+				const auto vertex = nodeIncidence.entries[entry] % 4;
+				flux += computationData.diffusiveFlux[vertex][tetrahedra];
+			}
+			computationData.flux[1][node] = flux;
+		}
+	});
+}
+
 void computeHamitonianFlux() {
-	uint nodeIndex = 0;
-	for (auto &type : boundaryConditions) {
-		auto &fluxHamiltonian = computationData.flux[0][nodeIndex];
-		auto &fluxDiffusive = computationData.flux[1][nodeIndex];
-		auto hamiltonArg = computationData.vertexGradient[nodeIndex];
-
-		switch (type) {
-			case NO_CONDITION:
-				fluxHamiltonian = 1 - recession[nodeIndex] * magnitude(hamiltonArg);
-				break;
-			case INLET:
-				fluxHamiltonian = 0;
-				fluxDiffusive = 0;
-				break;
-			case OUTLET:
-				fluxHamiltonian = 1 - recession[nodeIndex] * magnitude(hamiltonArg);
-				break;
-			case SYMMETRY: {
-				fluxHamiltonian = 1 - recession[nodeIndex] * magnitude(hamiltonArg);
-				break;
+	Parallel::forRange(boundaryConditions.size(), [](uint begin, uint end, uint) {
+		for (uint nodeIndex = begin; nodeIndex < end; ++nodeIndex) {
+			auto &type = boundaryConditions[nodeIndex];
+			auto &fluxHamiltonian = computationData.flux[0][nodeIndex];
+			auto &fluxDiffusive = computationData.flux[1][nodeIndex];
+			auto hamiltonArg = computationData.nodeGradient(nodeIndex);
+
+			switch (type) {
+				case NO_CONDITION:
+					fluxHamiltonian = 1 - recession[nodeIndex] * magnitude(hamiltonArg);
+					break;
+				case INLET:
+					fluxHamiltonian = 0;
+					fluxDiffusive = 0;
+					break;
+				case OUTLET:
+					fluxHamiltonian = 1 - recession[nodeIndex] * magnitude(hamiltonArg);
+					break;
+				case SYMMETRY: {
+					fluxHamiltonian = 1 - recession[nodeIndex] * magnitude(hamiltonArg);
+					break;
+				}
+				case OUTLET_SYMMETRY: {
+					fluxHamiltonian = 1 - recession[nodeIndex] * magnitude(hamiltonArg);
+					break;
+				}
+				default:
+					break;
+			};
+		}
+	});
+}
+
+void computeResults() {
+	Parallel::forRange(mesh.nodes.size(), [](uint begin, uint end, uint) {
+		for (uint node = begin; node < end; ++node) {
+			auto &uVertex = computationData.uVertex[node];
+			auto &flux = computationData.flux;
+			const auto &step = nodeTimeStep.empty() ? timeStep : nodeTimeStep[node];
+			uVertex += step * (flux[0][node] + input.diffusiveWeight * recession[node] * flux[1][node]);
+		}
+	});
+	timeTotal += timeStep * mesh.nodes.size();
+}
+// fused kernel of a whole iteration after the mean gradient: vertex gradient, symmetry, diffusive flux,
+// anisotropic recession, Hamiltonian flux and update in a single sweep over the incident tetrahedra
+// the diffusive flux is sum(weight * (gradient - vertexGradient) * normal), which is expanded as
+// sum(weight * gradient * normal) - vertexGradient * sum(weight * normal) so both sums are done in the same sweep
+// returns the squared Hamiltonian flux of the node, for the error
+double fusedNode(uint node) {
+	array<double, 3> vertexGradient = {0, 0, 0};
+	array<double, 3> weightedNormal = {0, 0, 0};
+	auto weightedFlux = 0.0;
+	for (auto entry = nodeIncidence.offset[node]; entry < nodeIncidence.offset[node + 1]; ++entry) {
+		const auto tetrahedra = nodeIncidence.entries[entry] / 4;
+		const auto vertex = nodeIncidence.entries[entry] % 4;
+		const auto &weight = tetrahedraGeometry.vertexWeight[vertex][tetrahedra];
+		auto normalFlux = 0.0;
+		for (uint component = 0; component < 3; ++component) {
+			const auto &gradient = computationData.gradient[component][tetrahedra];
+			const auto &normal = tetrahedraGeometry.normal[vertex][component][tetrahedra];
+			vertexGradient[component] += gradient * weight;
+			weightedNormal[component] += normal * weight;
+			normalFlux += gradient * normal;
+		}
+		weightedFlux += normalFlux * weight;
+	}
+
+	const auto &type = boundaryConditions[node];
+	if (type == SYMMETRY || type == OUTLET_SYMMETRY)
+		vertexGradient = symmetryProjection(symmetryConditions.at(node), vertexGradient);
+	computationData.setNodeGradient(node, vertexGradient);
+
+	auto &fluxHamiltonian = computationData.flux[0][node];
+	auto &fluxDiffusive = computationData.flux[1][node];
+	fluxDiffusive = weightedFlux - scalarProduct(vertexGradient, weightedNormal);
+	if (anisotropic)
+		recession[node] = Anisotropic::effectiveRecession(node, vertexGradient);
+
+	if (type == INLET) {
+		fluxHamiltonian = 0;
+		fluxDiffusive = 0;
+	} else {
+		fluxHamiltonian = 1 - recession[node] * magnitude(vertexGradient);
+	}
+
+	const auto &step = nodeTimeStep.empty() ? timeStep : nodeTimeStep[node];
+	computationData.uVertex[node] += step * (fluxHamiltonian + input.diffusiveWeight * recession[node] * fluxDiffusive);
+	return fluxHamiltonian * fluxHamiltonian;
+}
+
+double computeFused() {
+	static vector<double> errors;
+	errors.assign(Parallel::threads(), 0);
+	Parallel::forRange(mesh.nodes.size(), [](uint begin, uint end, uint thread) {
+		auto error = 0.0;
+		for (uint node = begin; node < end; ++node)
+			error += fusedNode(node);
+		errors[thread] = error;
+	});
+	timeTotal += timeStep * mesh.nodes.size();
+
+	auto error = 0.0;
+	for (auto &partialError : errors)
+		error += partialError;
+	return sqrt(error) / mesh.nodes.size();
+}
+
+// the other nodes keep their solution and fluxes
+void computeFused(const vector<uint> &nodes) {
+	Parallel::forRange(nodes.size(), [&](uint begin, uint end, uint) {
+		for (uint index = begin; index < end; ++index)
+			fusedNode(nodes[index]);
+	});
+	timeTotal += timeStep * mesh.nodes.size();
+}
+
+// Gauss-Seidel sweep in the order of the burn, the shortest path from the inlets along the edges at the recession of the nodes
+// the nodes are grouped in colors by their depth in the sweep, 1 + the largest color of their neighbours before them,
+// so the nodes of a color share no tetrahedra and each color is updated in parallel with the result of the serial sweep
+void computeSweepColors() {
+	vector<uint> offset;
+	vector<uint> neighbours;
+	computeNeighbours(offset, neighbours);
+	const auto nodes = mesh.nodes.size();
+
+	auto arrival = vector<double>(nodes, numeric_limits<double>::infinity());
+	priority_queue<pair<double, uint>, vector<pair<double, uint>>, greater<pair<double, uint>>> trial;
+	for (uint node = 0; node < nodes; ++node) {
+		if (boundaryConditions[node] == INLET) {
+			arrival[node] = 0;
+			trial.push({0, node});
+		}
+	}
+	while (!trial.empty()) {
+		const auto [time, node] = trial.top();
+		trial.pop();
+		if (time > arrival[node])
+			continue;
+		for (auto entry = offset[node]; entry < offset[node + 1]; ++entry) {
+			const auto &neighbour = neighbours[entry];
+			const auto speed = max((nodeRecession(node) + nodeRecession(neighbour)) / 2, numeric_limits<double>::min());
+			const auto candidate = time + magnitude(subtraction(mesh.nodes[neighbour], mesh.nodes[node])) / speed;
+			if (candidate < arrival[neighbour]) {
+				arrival[neighbour] = candidate;
+				trial.push({candidate, neighbour});
 			}
-			case OUTLET_SYMMETRY: {
-				fluxHamiltonian = 1 - recession[nodeIndex] * magnitude(hamiltonArg);
-				break;
+		}
+	}
+
+	// nodes that the burn does not reach go last, in mesh order
+	auto order = vector<uint>(nodes);
+	iota(order.begin(), order.end(), 0);
+	stable_sort(order.begin(), order.end(), [&arrival](uint a, uint b) { return arrival[a] < arrival[b]; });
+	auto position = vector<uint>(nodes);
+	for (uint index = 0; index < nodes; ++index)
+		position[order[index]] = index;
+
+	auto nodeColor = vector<uint>(nodes);
+	sweepColors.clear();
+	for (auto &node : order) {
+		uint color = 0;
+		for (auto entry = offset[node]; entry < offset[node + 1]; ++entry) {
+			const auto &neighbour = neighbours[entry];
+			if (position[neighbour] < position[node])
+				color = max(color, nodeColor[neighbour] + 1);
+		}
+		nodeColor[node] = color;
+		if (color == sweepColors.size())
+			sweepColors.emplace_back();
+		sweepColors[color].push_back(node);
+	}
+	for (auto &color : sweepColors)
+		sort(color.begin(), color.end());
+}
+
+// the mean gradient of the tetrahedra of each node is computed again just before its update,
+// so it reads the nodes already updated in the sweep
+// the rise of each node is limited to a fraction of its time step, otherwise the swept front runs ahead of the outlets,
+// whose one sided gradient then points upstream and sinks them without bound
+// the limit does not change the converged solution, where the updates vanish
+double computeSweep() {
+	const auto sweepRise = 0.75;
+	static vector<double> errors;
+	errors.assign(Parallel::threads(), 0);
+	for (auto &color : sweepColors) {
+		Parallel::forRange(color.size(), [&](uint begin, uint end, uint thread) {
+			auto error = 0.0;
+			for (auto index = begin; index < end; ++index) {
+				const auto &node = color[index];
+				for (auto entry = nodeIncidence.offset[node]; entry < nodeIncidence.offset[node + 1]; ++entry) {
+					if (input.storedGradient)
+						Tetrahedra::storedGradient(nodeIncidence.entries[entry] / 4);
+					else
+						Tetrahedra::meanGradient(nodeIncidence.entries[entry] / 4);
+				}
+				const auto previous = computationData.uVertex[node];
+				error += fusedNode(node);
+				const auto &step = nodeTimeStep.empty() ? timeStep : nodeTimeStep[node];
+				auto &u = computationData.uVertex[node];
+				u = min(u, previous + sweepRise * step);
 			}
-			default:
-				break;
-		};
-		nodeIndex++;
+			errors[thread] += error;
+		});
 	}
+	timeTotal += timeStep * mesh.nodes.size();
+
+	auto error = 0.0;
+	for (auto &partialError : errors)
+		error += partialError;
+	return sqrt(error) / mesh.nodes.size();
 }
 
-void computeResults() {
+// largest recession of the node, as in getMaxRecession
+double nodeRecession(uint node) {
+	return anisotropic ? max(recessionAnisotropic[node][0], recessionAnisotropic[node][1]) : recession[node];
+}
+
+// stable time step of each node, from the smallest height of its tetrahedra and its own recession,
+// instead of the worst tetrahedra and the largest recession of the whole mesh
+// timeStep is set to their mean, so timeTotal still adds timeStep for each node
+void computeLocalTimeStep() {
+	nodeTimeStep = vector<double>(mesh.nodes.size());
+	auto total = 0.0;
 	for (uint node = 0; node < mesh.nodes.size(); ++node) {
-		auto &uVertex = computationData.uVertex[node];
-		auto &flux = computationData.flux;
-		uVertex += timeStep * (flux[0][node] + input.diffusiveWeight * recession[node] * flux[1][node]);
-		timeTotal += timeStep;
+		const auto recession = nodeRecession(node);
+		auto &step = nodeTimeStep[node];
+		// nodes without tetrahedra or recession keep the global time step
+		if (isfinite(nodeHeight[node]) && recession > 0)
+			step = nodeHeight[node] * input.cfl / recession;
+		else
+			step = timeStep;
+		total += step;
 	}
+	timeStep = total / mesh.nodes.size();
 }
+
 double getMaxRecession() {
 	auto maxRecession = 0.0;
 	if (anisotropic) {
@@ -215,28 +671,42 @@ double getMaxRecession() {
 	}
 	return maxRecession;
 }
+array<double, 3> symmetryProjection(const vector<array<double, 3>> &symmetryVector, const array<double, 3> &vertexGradient) {
+	if (symmetryVector.size() == 1)
+		return crossProduct(crossProduct(symmetryVector[0], vertexGradient), symmetryVector[0]);
+
+	auto &symmetry1 = symmetryVector[0];
+	auto &symmetry2 = symmetryVector[1];
+
+	// vertexGradient = crossProduct(crossProduct(crossProduct(symmetry2, crossProduct(symmetry1, vertexGradient)), symmetry1), symmetry2);
+	auto s1 = multiplication(symmetry1, scalarProduct(vertexGradient, symmetry1));
+	auto s2 = multiplication(symmetry2, scalarProduct(vertexGradient, symmetry2));
+	return subtraction(vertexGradient, summation(s1, s2));
+}
 void applySymmetry() {
-	for (auto &[node, symmetryVector] : symmetryConditions) {
-		auto &vertexGradient = computationData.vertexGradient[node];
-		if (symmetryVector.size() == 1) {
-			vertexGradient = crossProduct(crossProduct(symmetryVector[0], vertexGradient), symmetryVector[0]);
-		} else {
-			auto &symmetry1 = symmetryVector[0];
-			auto &symmetry2 = symmetryVector[1];
-
-			// vertexGradient = crossProduct(crossProduct(crossProduct(symmetry2, crossProduct(symmetry1, vertexGradient)), symmetry1), symmetry2);
-			auto s1 = multiplication(symmetry1, scalarProduct(vertexGradient, symmetry1));
-			auto s2 = multiplication(symmetry2, scalarProduct(vertexGradient, symmetry2));
-			vertexGradient = subtraction(vertexGradient, summation(s1, s2));
+	Parallel::forRange(symmetryConditions.size(), [](uint begin, uint end, uint) {
+		auto symmetry = next(symmetryConditions.begin(), begin);
+		for (auto index = begin; index < end; ++index, ++symmetry) {
+			auto &[node, symmetryVector] = *symmetry;
+			computationData.setNodeGradient(node, symmetryProjection(symmetryVector, computationData.nodeGradient(node)));
 		}
-	}
+	});
 }
 
 double getError() {
-	auto error = 0.0;
-	for (uint node = 0; node < mesh.nodes.size(); ++node)
-		error += pow(computationData.flux[0][node], 2);
+	// partial sums are added in thread order, so the result does not depend on scheduling
+	static vector<double> errors;
+	errors.assign(Parallel::threads(), 0);
+	Parallel::forRange(mesh.nodes.size(), [](uint begin, uint end, uint thread) {
+		auto error = 0.0;
+		for (uint node = begin; node < end; ++node)
+			error += computationData.flux[0][node] * computationData.flux[0][node];
+		errors[thread] = error;
+	});
 
+	auto error = 0.0;
+	for (auto &partialError : errors)
+		error += partialError;
 	error = sqrt(error) / mesh.nodes.size();
 	return error;
 }
@@ -287,6 +757,131 @@ void setBoundaryConditions() {
 }
 //}}}
 
+namespace Eikonal { //{{{
+// smallest arrival time at x through the segment between xi and xj, with u linear along it
+// every candidate is the time of an actual path, so taking the minimum is always safe
+double edgeUpdate(const array<double, 3> &x, const array<double, 3> &xi, double ui, const array<double, 3> &xj, double uj, double speed) {
+	const auto w = subtraction(x, xi);
+	const auto edge = subtraction(xj, xi);
+	const auto delta = uj - ui;
+	auto time = min(ui + magnitude(w) / speed, uj + magnitude(subtraction(x, xj)) / speed);
+
+	// critical points of ui + s * delta + |w - s * edge| / speed
+	const auto a = scalarProduct(edge, edge);
+	const auto b = scalarProduct(edge, w);
+	const auto c = scalarProduct(w, w);
+	const auto k = a - pow(speed * delta, 2);
+	if (k <= 0)
+		return time;
+	const auto discriminant = b * b * k * k - a * k * (b * b - pow(speed * delta, 2) * c);
+	if (discriminant < 0)
+		return time;
+	for (auto sign : {-1.0, 1.0}) {
+		const auto s = b / a + sign * sqrt(discriminant) / (a * k);
+		if (s > 0 && s < 1)
+			time = min(time, ui + s * delta + magnitude(subtraction(w, multiplication(edge, s))) / speed);
+	}
+	return time;
+}
+
+// arrival time at the vertex through the opposite face: the value whose linear gradient in the tetrahedra has
+// magnitude 1 / speed, only valid when the characteristic going back from the vertex crosses the face
+double faceUpdate(uint tetrahedra, uint vertex, const array<double, 4> &u, double speed) {
+	const auto &gradientOperator = tetrahedraGeometry.gradientOperator;
+	auto operatorOf = [&](uint index) -> array<double, 3> {
+		return {gradientOperator[index][0][tetrahedra], gradientOperator[index][1][tetrahedra], gradientOperator[index][2][tetrahedra]};
+	};
+
+	array<double, 3> known = {0, 0, 0};
+	for (uint index = 0; index < 4; ++index) {
+		if (index != vertex)
+			known = summation(known, multiplication(operatorOf(index), u[index]));
+	}
+	const auto unknown = operatorOf(vertex);
+	const auto a = scalarProduct(unknown, unknown);
+	const auto b = 2 * scalarProduct(known, unknown);
+	const auto c = scalarProduct(known, known) - 1 / (speed * speed);
+	const auto discriminant = b * b - 4 * a * c;
+	if (discriminant < 0)
+		return numeric_limits<double>::infinity();
+
+	const auto time = (-b + sqrt(discriminant)) / (2 * a);
+	const auto gradient = summation(known, multiplication(unknown, time));
+	for (uint index = 0; index < 4; ++index) {
+		if (index != vertex && (u[index] > time || scalarProduct(gradient, operatorOf(index)) > 0))
+			return numeric_limits<double>::infinity();
+	}
+	return time;
+}
+
+// fast marching from the inlets over the tetrahedra, with the recession of each node as its speed
+// nodes that are not reached keep their value
+void fastMarching() {
+	auto &u = computationData.uVertex;
+	auto time = vector<double>(mesh.nodes.size(), numeric_limits<double>::infinity());
+	auto accepted = vector<bool>(mesh.nodes.size(), false);
+	priority_queue<pair<double, uint>, vector<pair<double, uint>>, greater<pair<double, uint>>> trial;
+	for (uint node = 0; node < mesh.nodes.size(); ++node) {
+		if (boundaryConditions[node] == INLET) {
+			time[node] = u[node];
+			trial.push({time[node], node});
+		}
+	}
+
+	while (!trial.empty()) {
+		const auto [nodeTime, node] = trial.top();
+		trial.pop();
+		if (accepted[node] || nodeTime > time[node])
+			continue;
+		accepted[node] = true;
+
+		for (auto entry = nodeIncidence.offset[node]; entry < nodeIncidence.offset[node + 1]; ++entry) {
+			const auto tetrahedra = nodeIncidence.entries[entry] / 4;
+			array<uint, 4> nodes;
+			array<double, 4> times;
+			uint known = 0;
+			for (uint vertex = 0; vertex < 4; ++vertex) {
+				nodes[vertex] = mesh.tetrahedra[tetrahedra][vertex] - 1;
+				times[vertex] = time[nodes[vertex]];
+				known += accepted[nodes[vertex]];
+			}
+
+			for (uint vertex = 0; vertex < 4; ++vertex) {
+				const auto &target = nodes[vertex];
+				const auto speed = Nodes::nodeRecession(target);
+				if (accepted[target] || boundaryConditions[target] == INLET || speed <= 0)
+					continue;
+
+				auto candidate = numeric_limits<double>::infinity();
+				if (known == 3)
+					candidate = faceUpdate(tetrahedra, vertex, times, speed);
+				for (uint first = 0; first < 4; ++first) {
+					if (first == vertex || !accepted[nodes[first]])
+						continue;
+					const auto &x = mesh.nodes[target];
+					candidate = min(candidate, times[first] + magnitude(subtraction(x, mesh.nodes[nodes[first]])) / speed);
+					for (uint second = first + 1; second < 4; ++second) {
+						if (second != vertex && accepted[nodes[second]])
+							candidate = min(candidate, edgeUpdate(x, mesh.nodes[nodes[first]], times[first], mesh.nodes[nodes[second]], times[second], speed));
+					}
+				}
+
+				if (candidate < time[target]) {
+					time[target] = candidate;
+					trial.push({candidate, target});
+				}
+			}
+		}
+	}
+
+	for (uint node = 0; node < mesh.nodes.size(); ++node) {
+		if (accepted[node])
+			u[node] = time[node];
+	}
+}
+}
+//}}}
+
 namespace Anisotropic { //{{{
 void computeMatrix() {
 	recessionMatrix = vector<array<array<double, 3>, 3>>(mesh.nodes.size());
@@ -318,16 +913,20 @@ void computeMatrix() {
 		recessionMatrix[node] = Matrix::multiplication(_op, rotationMatrix);
 	}
 }
+double effectiveRecession(uint node, const array<double, 3> &vertexGradient) {
+	array<array<double, 1>, 3> flowDirection = {{
+	    {vertexGradient[0]},
+	    {vertexGradient[1]},
+	    {vertexGradient[2]},
+	}};
+	auto &matrix = recessionMatrix[node];
+	auto effectiveRecession = Matrix::multiplication(matrix, flowDirection);
+	return sqrt(pow(effectiveRecession[0][0], 2) + pow(effectiveRecession[1][0], 2) + pow(effectiveRecession[2][0], 2));
+}
 void computeRecession() {
-	for (uint node = 0; node < mesh.nodes.size(); ++node) {
-		array<array<double, 1>, 3> flowDirection = {{
-		    {computationData.gradient[node][0]},
-		    {computationData.gradient[node][1]},
-		    {computationData.gradient[node][2]},
-		}};
-		auto &matrix = recessionMatrix[node];
-		auto effectiveRecession = Matrix::multiplication(matrix, flowDirection);
-		recession[node] = sqrt(pow(effectiveRecession[0][0], 2) + pow(effectiveRecession[1][0], 2) + pow(effectiveRecession[2][0], 2));
-	}
+	Parallel::forRange(mesh.nodes.size(), [](uint begin, uint end, uint) {
+		for (uint node = begin; node < end; ++node)
+			recession[node] = effectiveRecession(node, computationData.nodeGradient(node));
+	});
 }
 } //}}}
@@ -0,0 +1,116 @@
+#include <condition_variable>
+#include <mutex>
+#include <src/headers/parallel.h>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace Parallel {
+namespace {
+struct Pool {
+	vector<thread> workers;
+	// the interface may extract isosurfaces while the solver runs, each call waits for the previous one
+	mutex callers;
+	mutex lock;
+	condition_variable start;
+	condition_variable done;
+	const function<void(uint, uint, uint)> *task = nullptr;
+	uint size = 0;
+	uint generation = 0;
+	uint pending = 0;
+	bool stopping = false;
+
+	uint threads() {
+		return workers.size() + 1;
+	}
+
+	void run(uint thread, uint size) {
+		auto begin = uint(uint64_t(size) * thread / threads());
+		auto end = uint(uint64_t(size) * (thread + 1) / threads());
+		if (begin < end)
+			(*task)(begin, end, thread);
+	}
+
+	void work(uint thread, uint seen) {
+		while (true) {
+			unique_lock<mutex> guard(lock);
+			start.wait(guard, [&] { return stopping || generation != seen; });
+			if (stopping)
+				return;
+			seen = generation;
+			auto currentSize = size;
+			guard.unlock();
+
+			run(thread, currentSize);
+
+			guard.lock();
+			if (--pending == 0)
+				done.notify_one();
+		}
+	}
+
+	void stop() {
+		{
+			lock_guard<mutex> guard(lock);
+			stopping = true;
+		}
+		start.notify_all();
+		for (auto &worker : workers)
+			worker.join();
+		workers.clear();
+		stopping = false;
+	}
+
+	~Pool() {
+		stop();
+	}
+};
+
+Pool pool;
+}
+
+void setThreads(uint threads) {
+	if (threads == 0)
+		threads = max(1u, std::thread::hardware_concurrency());
+	lock_guard<mutex> caller(pool.callers);
+	if (threads == pool.threads())
+		return;
+
+	pool.stop();
+	for (uint thread = 1; thread < threads; ++thread)
+		pool.workers.emplace_back(&Pool::work, &pool, thread, pool.generation);
+}
+
+uint threads() {
+	return pool.threads();
+}
+
+void forRange(uint size, const function<void(uint begin, uint end, uint thread)> &function, const std::function<void(uint threads)> &prepare) {
+	// the pool may be resized by another thread, so it is only read once the call owns it
+	lock_guard<mutex> caller(pool.callers);
+	if (pool.workers.empty() || size < pool.threads()) {
+		if (prepare)
+			prepare(1);
+		if (size > 0)
+			function(0, size, 0);
+		return;
+	}
+	if (prepare)
+		prepare(pool.threads());
+
+	{
+		lock_guard<mutex> guard(pool.lock);
+		pool.task = &function;
+		pool.size = size;
+		pool.pending = pool.workers.size();
+		++pool.generation;
+	}
+	pool.start.notify_all();
+
+	pool.run(0, size);
+
+	unique_lock<mutex> guard(pool.lock);
+	pool.done.wait(guard, [] { return pool.pending == 0; });
+}
+}
@@ -1,9 +1,14 @@
 #ifdef _WIN32
 #define _USE_MATH_DEFINES
 #endif
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <unordered_map>
 #include <src/headers/globals.h>
 #include <src/headers/operations.h>
+#include <src/headers/parallel.h>
 #include <src/headers/plotData.h>
 
 using namespace std;
@@ -18,221 +23,264 @@ double lerp(double x1, double x2, double t) {
 }
 #endif
 
-IsocontourData isosurfaceData(double value) {
-	IsocontourData data;
-	for (uint tetrahedra = 0; tetrahedra < mesh.tetrahedra.size(); ++tetrahedra) {
-		auto &_nodes = mesh.tetrahedra[tetrahedra];
-		array<uint, 4> nodes;
-		for (uint i = 0; i < 4; ++i)
-			nodes[i] = _nodes[i] - 1;
-
-		vector<array<double, 3>> intersectionPoints;
-
-		// 4 vertices and 2 nodes, the combination is 6
-		for (int i = 0; i < 4; ++i) {
-			for (int j = i + 1; j < 4; ++j) {
-				auto uVertex1 = computationData.uVertex[nodes[i]];
-				auto uVertex2 = computationData.uVertex[nodes[j]];
-
-				auto value1 = uVertex1 - value;
-				auto value2 = uVertex2 - value;
-
-				if (value1 * value2 < 0) {
-					auto &node1 = mesh.nodes[nodes[i]];
-					auto &node2 = mesh.nodes[nodes[j]];
-
-					auto &x1 = node1[0];
-					auto &y1 = node1[1];
-					auto &z1 = node1[2];
-
-					auto &x2 = node2[0];
-					auto &y2 = node2[1];
-					auto &z2 = node2[2];
-
-					double uV1, uV2, ux1, ux2, uy1, uy2, uz1, uz2;
-
-					// sort the vertices
-					// so when reversing the order, the result is the same
-					if (value1 < 0) {
-						uV1 = uVertex1;
-						uV2 = uVertex2;
-
-						ux1 = x1;
-						ux2 = x2;
-
-						uy1 = y1;
-						uy2 = y2;
-
-						uz1 = z1;
-						uz2 = z2;
-					} else {
-						uV1 = uVertex2;
-						uV2 = uVertex1;
-
-						ux1 = x2;
-						ux2 = x1;
-
-						uy1 = y2;
-						uy2 = y1;
-
-						uz1 = z2;
-						uz2 = z1;
-					}
+// marching tetrahedra cases, indexed by the mask of the vertices with u >= value
+// intersected edges in winding order for a positively oriented tetrahedra, so the normal is opposite to the gradient
+// the 4 edges of the two vertices cases form a cycle around the quadrilateral
+const array<array<uint, 2>, 6> tetrahedraEdges = {{{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}}};
+const array<pair<uint, array<uint, 4>>, 16> marchingCases = {{
+    {0, {0, 0, 0, 0}},
+    {3, {0, 1, 2, 0}},
+    {3, {0, 4, 3, 0}},
+    {4, {1, 2, 4, 3}},
+    {3, {1, 3, 5, 0}},
+    {4, {0, 3, 5, 2}},
+    {4, {0, 4, 5, 1}},
+    {3, {2, 4, 5, 0}},
+    {3, {2, 5, 4, 0}},
+    {4, {0, 1, 5, 4}},
+    {4, {0, 2, 5, 3}},
+    {3, {1, 5, 3, 0}},
+    {4, {1, 3, 4, 2}},
+    {3, {0, 3, 4, 0}},
+    {3, {0, 2, 1, 0}},
+    {0, {0, 0, 0, 0}},
+}};
+
+// the center of each tree node is the median of the midpoints of its ranges,
+// so each side holds at most half of them and the depth is logarithmic
+int buildIsosurfaceNode(vector<uint> tetrahedraList) {
+	auto &index = isosurfaceIndex;
+	if (tetrahedraList.empty())
+		return -1;
+
+	auto midpoints = vector<double>(tetrahedraList.size());
+	for (uint position = 0; position < tetrahedraList.size(); ++position)
+		midpoints[position] = (index.minimum[tetrahedraList[position]] + index.maximum[tetrahedraList[position]]) / 2;
+	auto median = midpoints.begin() + midpoints.size() / 2;
+	nth_element(midpoints.begin(), median, midpoints.end());
+	const auto center = *median;
+	midpoints = vector<double>();
+
+	vector<uint> left, right;
+	const uint begin = index.byMinimum.size();
+	for (auto &tetrahedra : tetrahedraList) {
+		if (index.maximum[tetrahedra] < center)
+			left.push_back(tetrahedra);
+		else if (index.minimum[tetrahedra] > center)
+			right.push_back(tetrahedra);
+		else
+			index.byMinimum.push_back(tetrahedra);
+	}
+	tetrahedraList = vector<uint>();
+	const uint end = index.byMinimum.size();
+	index.byMaximum.insert(index.byMaximum.end(), index.byMinimum.begin() + begin, index.byMinimum.end());
+	sort(index.byMinimum.begin() + begin, index.byMinimum.end(), [&index](uint a, uint b) { return index.minimum[a] < index.minimum[b]; });
+	sort(index.byMaximum.begin() + begin, index.byMaximum.end(), [&index](uint a, uint b) { return index.maximum[a] > index.maximum[b]; });
+
+	const int node = index.nodes.size();
+	index.nodes.push_back({center, begin, end, -1, -1});
+	const auto leftNode = buildIsosurfaceNode(move(left));
+	const auto rightNode = buildIsosurfaceNode(move(right));
+	index.nodes[node].left = leftNode;
+	index.nodes[node].right = rightNode;
+	return node;
+}
 
-					auto t = (value - uV1) / (uV2 - uV1);
+void buildIsosurfaceIndex() {
+	auto &index = isosurfaceIndex;
+	index.clear();
+	index.minimum = vector<double>(mesh.tetrahedra.size());
+	index.maximum = vector<double>(mesh.tetrahedra.size());
+	for (uint tetrahedra = 0; tetrahedra < mesh.tetrahedra.size(); ++tetrahedra) {
+		auto &nodes = mesh.tetrahedra[tetrahedra];
+		index.minimum[tetrahedra] = index.maximum[tetrahedra] = computationData.uVertex[nodes[0] - 1];
+		for (uint vertex = 1; vertex < 4; ++vertex) {
+			index.minimum[tetrahedra] = min(index.minimum[tetrahedra], computationData.uVertex[nodes[vertex] - 1]);
+			index.maximum[tetrahedra] = max(index.maximum[tetrahedra], computationData.uVertex[nodes[vertex] - 1]);
+		}
+	}
+	index.byMinimum.reserve(mesh.tetrahedra.size());
+	index.byMaximum.reserve(mesh.tetrahedra.size());
 
-					auto x = lerp(ux1, ux2, t);
-					auto y = lerp(uy1, uy2, t);
-					auto z = lerp(uz1, uz2, t);
+	auto tetrahedraList = vector<uint>(mesh.tetrahedra.size());
+	iota(tetrahedraList.begin(), tetrahedraList.end(), 0);
+	buildIsosurfaceNode(move(tetrahedraList));
+	index.built = true;
+}
 
-					intersectionPoints.push_back({x, y, z});
-				}
+// tetrahedra with min u < value <= max u, in increasing order
+vector<uint> isosurfaceTetrahedra(double value) {
+	auto &index = isosurfaceIndex;
+	vector<uint> tetrahedraList;
+	for (int node = index.nodes.empty() ? -1 : 0; node >= 0;) {
+		auto &treeNode = index.nodes[node];
+		if (value < treeNode.center) {
+			// every range of the node contains the center, so max u >= value
+			for (auto position = treeNode.begin; position < treeNode.end && index.minimum[index.byMinimum[position]] < value; ++position)
+				tetrahedraList.push_back(index.byMinimum[position]);
+			node = treeNode.left;
+		} else {
+			for (auto position = treeNode.begin; position < treeNode.end && index.maximum[index.byMaximum[position]] >= value; ++position) {
+				if (index.minimum[index.byMaximum[position]] < value)
+					tetrahedraList.push_back(index.byMaximum[position]);
 			}
+			node = treeNode.right;
 		}
+	}
+	// same order as visiting all the tetrahedra
+	sort(tetrahedraList.begin(), tetrahedraList.end());
+	return tetrahedraList;
+}
 
-		switch (intersectionPoints.size()) {
-			case 0:
-				break;
-			case 3: {
-				array<uint, 3> triangleNodes = {};
-				for (int i = 0; i < 3; ++i) {
-					// check if the intersection point is already in the nodes
-					auto &point = intersectionPoints[i];
-					uint nodeIndex = 0;
-					for (; nodeIndex < data.nodes.size(); ++nodeIndex) {
-						auto &node = data.nodes[nodeIndex];
-						if (node[0] == point[0] && node[1] == point[1] && node[2] == point[2]) {
-							break;
-						}
-					}
-					if (nodeIndex == data.nodes.size()) {
-						data.nodes.push_back(point);
-					}
-					triangleNodes[i] = nodeIndex;
-				}
-				auto normal = crossProduct(
-				    subtraction(data.nodes[triangleNodes[1]], data.nodes[triangleNodes[0]]),
-				    subtraction(data.nodes[triangleNodes[2]], data.nodes[triangleNodes[0]])
-				);
-				auto flowDirection = computationData.gradient[tetrahedra];
-				if (scalarProduct(normal, flowDirection) > 0) {
-					swap(triangleNodes[1], triangleNodes[2]);
-				}
-				data.triangles.push_back(triangleNodes);
-				break;
-			}
-			case 4: {
-				// order intersection points
-				array<uint, 4> orderedPoints;
-				// center point
-				// auto sum1 = summation(intersectionPoints[0], intersectionPoints[1]);
-				// auto sum2 = summation(intersectionPoints[2], intersectionPoints[3]);
-				auto sum = summation(
-				    intersectionPoints[0],
-				    intersectionPoints[1],
-				    intersectionPoints[2],
-				    intersectionPoints[3]
-				);
-				auto center = multiplication(sum, 0.25);
-				// sort by angle
-				auto OA = subtraction(intersectionPoints[0], center);
-				auto normal = crossProduct(OA, subtraction(intersectionPoints[1], center));
-				auto mOA = magnitude(OA);
-				array<double, 3> angles;
-				for (int i = 1; i < 4; ++i) {
-					auto OB = subtraction(intersectionPoints[i], center);
-					auto mOB = magnitude(OB);
-					auto ab = scalarProduct(OA, OB);
-					auto xab = crossProduct(OA, OB);
-					auto angleArg = ab / (mOA * mOB);
-					if (abs(angleArg) > 1)
-						angleArg = angleArg / abs(angleArg);
-					auto _angle = acos(angleArg);
-					if (scalarProduct(normal, xab) < 0)
-						_angle = 2 * M_PI - _angle;
-					angles[i - 1] = _angle;
-				}
-				orderedPoints[0] = 0;
-				for (int i = 1; i < 4; ++i) {
-					auto minAngleIndex = min_element(angles.begin(), angles.end()) - angles.begin();
-					orderedPoints[i] = minAngleIndex + 1;
-					angles[minAngleIndex] = INFINITY;
-				}
-
-				// minimum diagonal method for triangulation
-				// doesn't seem to have any effect
-				auto diagonal1 = subtraction(intersectionPoints[orderedPoints[0]], intersectionPoints[orderedPoints[2]]);
-				auto diagonal2 = subtraction(intersectionPoints[orderedPoints[1]], intersectionPoints[orderedPoints[3]]);
-				array<uint, 4> triangleVertices1;
-				array<uint, 4> triangleVertices2;
-				if (magnitude(diagonal1) < magnitude(diagonal2)) {
-					triangleVertices1 = {orderedPoints[0], orderedPoints[1], orderedPoints[2]};
-					triangleVertices2 = {orderedPoints[0], orderedPoints[2], orderedPoints[3]};
-				} else {
-					triangleVertices1 = {orderedPoints[0], orderedPoints[1], orderedPoints[3]};
-					triangleVertices2 = {orderedPoints[1], orderedPoints[2], orderedPoints[3]};
-				}
-
-				array<uint, 3> triangleNodes1 = {};
-				array<uint, 3> triangleNodes2 = {};
+// part of an isosurface extracted by a single thread, with the mesh edge of each of its points
+struct IsosurfacePart {
+	IsocontourData data;
+	vector<uint64_t> edges;
+	unordered_map<uint64_t, uint> edgeNodes;
+};
+
+// intersection points are welded by the mesh edge they lie on, so the surface is watertight
+// and each point is only computed once
+uint weldPoint(IsosurfacePart &part, uint node1, uint node2, double value) {
+	const auto edge = uint64_t(min(node1, node2)) << 32 | max(node1, node2);
+	auto [edgeNode, inserted] = part.edgeNodes.try_emplace(edge, part.data.nodes.size());
+	if (inserted) {
+		// interpolated from the node below the value, so the point does not depend on the order of the nodes
+		if (computationData.uVertex[node1] >= value)
+			swap(node1, node2);
+		const auto &u1 = computationData.uVertex[node1];
+		const auto &u2 = computationData.uVertex[node2];
+		const auto t = (value - u1) / (u2 - u1);
+		const auto &coordinates1 = mesh.nodes[node1];
+		const auto &coordinates2 = mesh.nodes[node2];
+		part.data.nodes.push_back({lerp(coordinates1[0], coordinates2[0], t), lerp(coordinates1[1], coordinates2[1], t), lerp(coordinates1[2], coordinates2[2], t)});
+		part.edges.push_back(edge);
+	}
+	return edgeNode->second;
+}
 
-				for (int i = 0; i < 3; ++i) {
-					// triangle 1
-					auto &point = intersectionPoints[triangleVertices1[i]];
-					uint nodeIndex = 0;
-					for (; nodeIndex < data.nodes.size(); ++nodeIndex) {
-						auto &node = data.nodes[nodeIndex];
-						if (node[0] == point[0] && node[1] == point[1] && node[2] == point[2]) {
-							break;
-						}
-					}
-					if (nodeIndex == data.nodes.size()) {
-						data.nodes.push_back(point);
-					}
-					triangleNodes1[i] = nodeIndex;
+void extractTetrahedra(IsosurfacePart &part, uint tetrahedra, double value) {
+	array<uint, 4> nodes;
+	uint mask = 0;
+	for (uint vertex = 0; vertex < 4; ++vertex) {
+		nodes[vertex] = mesh.tetrahedra[tetrahedra][vertex] - 1;
+		if (computationData.uVertex[nodes[vertex]] >= value)
+			mask |= 1 << vertex;
+	}
+	const auto &[count, edges] = marchingCases[mask];
+	if (count == 0)
+		return;
+
+	array<uint, 4> points;
+	for (uint index = 0; index < count; ++index) {
+		const auto &edge = tetrahedraEdges[edges[index]];
+		points[index] = weldPoint(part, nodes[edge[0]], nodes[edge[1]], value);
+	}
 
-					// triangle 2
-					point = intersectionPoints[triangleVertices2[i]];
-					nodeIndex = 0;
-					for (; nodeIndex < data.nodes.size(); ++nodeIndex) {
-						auto &node = data.nodes[nodeIndex];
-						if (node[0] == point[0] && node[1] == point[1] && node[2] == point[2]) {
-							break;
-						}
-					}
-					if (nodeIndex == data.nodes.size()) {
-						data.nodes.push_back(point);
-					}
-					triangleNodes2[i] = nodeIndex;
-				}
-				auto flowDirection = computationData.gradient[tetrahedra];
-				auto normal1 = crossProduct(
-				    subtraction(data.nodes[triangleNodes1[1]], data.nodes[triangleNodes1[0]]),
-				    subtraction(data.nodes[triangleNodes1[2]], data.nodes[triangleNodes1[0]])
-				);
-				if (scalarProduct(normal1, flowDirection) > 0) {
-					swap(triangleNodes1[1], triangleNodes1[2]);
-				}
+	// the winding of the table assumes a positively oriented tetrahedra, so it is flipped for negatively oriented ones
+	// and the normal is always opposite to the true gradient of u, whatever the orientation
+	// the computed gradient has the sign of the jacobi determinant, so for negatively oriented tetrahedra it points along it
+	const auto &nodeO = mesh.nodes[nodes[0]];
+	const auto flip = scalarProduct(
+	                      crossProduct(subtraction(mesh.nodes[nodes[1]], nodeO), subtraction(mesh.nodes[nodes[2]], nodeO)),
+	                      subtraction(mesh.nodes[nodes[3]], nodeO)) < 0;
+	auto &data = part.data;
+	auto addTriangle = [&data, flip](uint node1, uint node2, uint node3) {
+		if (flip)
+			data.triangles.push_back({node1, node3, node2});
+		else
+			data.triangles.push_back({node1, node2, node3});
+	};
+
+	if (count == 3) {
+		addTriangle(points[0], points[1], points[2]);
+		return;
+	}
+	// minimum diagonal method for triangulation
+	auto diagonal1 = subtraction(data.nodes[points[0]], data.nodes[points[2]]);
+	auto diagonal2 = subtraction(data.nodes[points[1]], data.nodes[points[3]]);
+	if (scalarProduct(diagonal1, diagonal1) < scalarProduct(diagonal2, diagonal2)) {
+		addTriangle(points[0], points[1], points[2]);
+		addTriangle(points[0], points[2], points[3]);
+	} else {
+		addTriangle(points[0], points[1], points[3]);
+		addTriangle(points[1], points[2], points[3]);
+	}
+}
 
-				auto normal2 = crossProduct(
-				    subtraction(data.nodes[triangleNodes2[1]], data.nodes[triangleNodes2[0]]),
-				    subtraction(data.nodes[triangleNodes2[2]], data.nodes[triangleNodes2[0]])
-				);
-				if (scalarProduct(normal2, flowDirection) > 0) {
-					swap(triangleNodes2[1], triangleNodes2[2]);
-				}
+// each thread extracts a contiguous range of tetrahedra, the parts are then merged in thread order,
+// so the points and triangles are in the same order as extracting all the tetrahedra in a single thread
+IsocontourData isosurfaceData(double value) {
+	vector<uint> tetrahedraList;
+	const bool indexed = isosurfaceIndex.built;
+	if (indexed)
+		tetrahedraList = isosurfaceTetrahedra(value);
+	const uint size = indexed ? tetrahedraList.size() : mesh.tetrahedra.size();
+
+	// the solver may change the threads meanwhile, so the parts are sized by the call itself
+	vector<IsosurfacePart> parts;
+	const auto sizeParts = [&](uint threads) { parts = vector<IsosurfacePart>(threads); };
+	Parallel::forRange(size, [&](uint begin, uint end, uint thread) {
+		for (auto position = begin; position < end; ++position)
+			extractTetrahedra(parts[thread], indexed ? tetrahedraList[position] : position, value);
+	}, sizeParts);
+	// with a single thread, or when forRange runs inline, everything is in the first part
+	if (parts.size() == 1)
+		return move(parts[0].data);
+
+	// points found by several threads are kept where they are first found
+	IsocontourData data;
+	unordered_map<uint64_t, uint> edgeNodes;
+	auto nodeMaps = vector<vector<uint>>(parts.size());
+	auto triangleOffsets = vector<uint>(parts.size() + 1);
+	for (uint thread = 0; thread < parts.size(); ++thread) {
+		auto &part = parts[thread];
+		nodeMaps[thread] = vector<uint>(part.edges.size());
+		for (uint node = 0; node < part.edges.size(); ++node) {
+			auto [edgeNode, inserted] = edgeNodes.try_emplace(part.edges[node], data.nodes.size());
+			if (inserted)
+				data.nodes.push_back(part.data.nodes[node]);
+			nodeMaps[thread][node] = edgeNode->second;
+		}
+		triangleOffsets[thread + 1] = triangleOffsets[thread] + part.data.triangles.size();
+	}
 
-				data.triangles.push_back(triangleNodes1);
-				data.triangles.push_back(triangleNodes2);
-				break;
+	data.triangles = vector<array<uint, 3>>(triangleOffsets.back());
+	Parallel::forRange(parts.size(), [&](uint begin, uint end, uint) {
+		for (auto thread = begin; thread < end; ++thread) {
+			auto &triangles = parts[thread].data.triangles;
+			for (uint triangle = 0; triangle < triangles.size(); ++triangle) {
+				for (uint vertex = 0; vertex < 3; ++vertex)
+					data.triangles[triangleOffsets[thread] + triangle][vertex] = nodeMaps[thread][triangles[triangle][vertex]];
 			}
-			default:
-				throw runtime_error("Unexpected number of intersection points");
 		}
-	}
+	});
 	return data;
 }
 
+// area of the isosurface inside a single tetrahedra, for the case given by the mask of its nodes
+double isosurfaceArea(const array<uint, 4> &nodes, uint mask, double value) {
+	const auto &[count, edges] = marchingCases[mask];
+	array<array<double, 3>, 4> points;
+	for (uint index = 0; index < count; ++index) {
+		auto node1 = nodes[tetrahedraEdges[edges[index]][0]];
+		auto node2 = nodes[tetrahedraEdges[edges[index]][1]];
+		if (computationData.uVertex[node1] >= value)
+			swap(node1, node2);
+		const auto &u1 = computationData.uVertex[node1];
+		const auto &u2 = computationData.uVertex[node2];
+		const auto t = (value - u1) / (u2 - u1);
+		for (uint component = 0; component < 3; ++component)
+			points[index][component] = lerp(mesh.nodes[node1][component], mesh.nodes[node2][component], t);
+	}
+	// the quadrilaterals are planar, so their area is half the cross product of the diagonals
+	if (count == 3)
+		return magnitude(crossProduct(subtraction(points[1], points[0]), subtraction(points[2], points[0]))) / 2;
+	return magnitude(crossProduct(subtraction(points[2], points[0]), subtraction(points[3], points[1]))) / 2;
+}
+
+// the area of every level is added in a single sweep over the tetrahedra,
+// each tetrahedra only contributes to the levels in (min u, max u] of its nodes
 array<vector<double>, 2> burnAreaData(uint numberOfAreas) {
 	array<vector<double>, 2> data;
 	data.fill(vector<double>(numberOfAreas, 0));
@@ -248,20 +296,36 @@ array<vector<double>, 2> burnAreaData(uint numberOfAreas) {
 	uMax -= (uMax - uMin) * epsilon;
 	uMin += (uMax - uMin) * epsilon;
 
-	for (uint area = 0; area < numberOfAreas; ++area) {
+	for (uint area = 0; area < numberOfAreas; ++area)
 		burnDepth[area] = uMin + (uMax - uMin) * area / (numberOfAreas - 1);
 
-		auto surfaceData = isosurfaceData(burnDepth[area]);
-		for (auto &triangle : surfaceData.triangles) {
-			auto &node1 = surfaceData.nodes[triangle[0]];
-			auto &node2 = surfaceData.nodes[triangle[1]];
-			auto &node3 = surfaceData.nodes[triangle[2]];
-			auto areaTriangle = magnitude(crossProduct(subtraction(node2, node1), subtraction(node3, node1))) / 2;
-			burnArea[area] += areaTriangle;
+	// areas of each thread are added in thread order, so the result does not depend on scheduling
+	vector<vector<double>> areas;
+	const auto sizeAreas = [&](uint threads) { areas = vector<vector<double>>(threads, vector<double>(numberOfAreas)); };
+	Parallel::forRange(mesh.tetrahedra.size(), [&](uint begin, uint end, uint thread) {
+		for (auto tetrahedra = begin; tetrahedra < end; ++tetrahedra) {
+			array<uint, 4> nodes;
+			array<double, 4> u;
+			for (uint vertex = 0; vertex < 4; ++vertex) {
+				nodes[vertex] = mesh.tetrahedra[tetrahedra][vertex] - 1;
+				u[vertex] = computationData.uVertex[nodes[vertex]];
+			}
+			const auto [uTetrahedraMin, uTetrahedraMax] = minmax_element(u.begin(), u.end());
+			auto level = upper_bound(burnDepth.begin(), burnDepth.end(), *uTetrahedraMin) - burnDepth.begin();
+			for (; level < numberOfAreas && burnDepth[level] <= *uTetrahedraMax; ++level) {
+				uint mask = 0;
+				for (uint vertex = 0; vertex < 4; ++vertex) {
+					if (u[vertex] >= burnDepth[level])
+						mask |= 1 << vertex;
+				}
+				areas[thread][level] += isosurfaceArea(nodes, mask, burnDepth[level]);
+			}
 		}
+	}, sizeAreas);
+	for (auto &threadAreas : areas) {
+		for (uint level = 0; level < numberOfAreas; ++level)
+			burnArea[level] += threadAreas[level];
 	}
 
-	data[0] = burnArea;
-	data[1] = burnDepth;
 	return data;
 }
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <numeric>
+#include <src/headers/operations.h>
+#include <src/headers/reorder.h>
+
+using namespace std;
+
+namespace Reorder {
+// spreads the lowest 21 bits of the value so there are two zeros between each bit
+uint64_t spreadBits(uint64_t value) {
+	value &= 0x1fffff;
+	value = (value | value << 32) & 0x1f00000000ffff;
+	value = (value | value << 16) & 0x1f0000ff0000ff;
+	value = (value | value << 8) & 0x100f00f00f00f00f;
+	value = (value | value << 4) & 0x10c30c30c30c30c3;
+	value = (value | value << 2) & 0x1249249249249249;
+	return value;
+}
+
+// position of each node along the Morton (Z-order) curve of its bounding box
+vector<uint64_t> mortonCodes() {
+	array<double, 3> minimum = mesh.nodes[0], maximum = mesh.nodes[0];
+	for (auto &node : mesh.nodes) {
+		for (uint component = 0; component < 3; ++component) {
+			minimum[component] = min(minimum[component], node[component]);
+			maximum[component] = max(maximum[component], node[component]);
+		}
+	}
+
+	auto codes = vector<uint64_t>(mesh.nodes.size());
+	for (uint node = 0; node < mesh.nodes.size(); ++node) {
+		for (uint component = 0; component < 3; ++component) {
+			const auto size = maximum[component] - minimum[component];
+			const auto scaled = size > 0 ? (mesh.nodes[node][component] - minimum[component]) / size : 0;
+			codes[node] |= spreadBits(uint64_t(scaled * 0x1fffff)) << component;
+		}
+	}
+	return codes;
+}
+
+// the nodes are sorted along the curve and the tetrahedra by their first node in the new numbering,
+// the node data already read (conditions and recessions) is permuted along
+void reorderMesh() {
+	if (mesh.nodes.empty())
+		return;
+
+	const auto codes = mortonCodes();
+	auto permutation = vector<uint>(mesh.nodes.size());
+	iota(permutation.begin(), permutation.end(), 0);
+	stable_sort(permutation.begin(), permutation.end(), [&codes](uint a, uint b) { return codes[a] < codes[b]; });
+	auto newNode = vector<uint>(mesh.nodes.size());
+	for (uint node = 0; node < mesh.nodes.size(); ++node)
+		newNode[permutation[node]] = node;
+
+	// values[index] = values[order[index]] for vectors with one value per element
+	auto permute = [](auto &values, const vector<uint> &order) {
+		if (values.size() != order.size())
+			return;
+		auto permuted = values;
+		for (uint index = 0; index < order.size(); ++index)
+			permuted[index] = values[order[index]];
+		values = permuted;
+	};
+	permute(mesh.nodes, permutation);
+	permute(nodeConditions, permutation);
+	permute(recession, permutation);
+	permute(recessionAnisotropic, permutation);
+	// the mesh may have been reordered before, so the permutations are composed
+	if (nodePermutation.empty())
+		nodePermutation = permutation;
+	else
+		permute(nodePermutation, permutation);
+
+	for (auto &tetrahedra : mesh.tetrahedra) {
+		for (auto &node : tetrahedra)
+			node = newNode[node - 1] + 1;
+	}
+	for (auto &triangle : mesh.triangles) {
+		for (auto &node : triangle)
+			node = newNode[node - 1] + 1;
+	}
+
+	auto order = vector<uint>(mesh.tetrahedra.size());
+	iota(order.begin(), order.end(), 0);
+	stable_sort(order.begin(), order.end(), [](uint a, uint b) {
+		return *min_element(mesh.tetrahedra[a].begin(), mesh.tetrahedra[a].end()) <
+		       *min_element(mesh.tetrahedra[b].begin(), mesh.tetrahedra[b].end());
+	});
+	permute(mesh.tetrahedra, order);
+	if (tetrahedraPermutation.empty())
+		tetrahedraPermutation = order;
+	else
+		permute(tetrahedraPermutation, order);
+
+	tetrahedraColors.clear();
+	Nodes::computeIncidence();
+}
+}
@@ -0,0 +1,240 @@
+#include <cmath>
+#include <limits>
+#include <src/headers/activeSet.h>
+#include <src/headers/globals.h>
+#include <src/headers/implicit.h>
+#include <src/headers/iosystem.h>
+#include <src/headers/operations.h>
+#include <src/headers/parallel.h>
+#include <src/headers/solver.h>
+
+using namespace std;
+
+namespace Solver {
+// state of the convergence controller
+namespace {
+const double growthFactor = 1.25;
+const uint growthIterations = 10;
+const double backoffFactor = 0.5;
+const double spikeFactor = 2;
+const double plateauImprovement = 0.01;
+
+double initialCfl;
+double failedCfl;
+double lastError;
+double bestError;
+uint bestIteration;
+uint decreasing;
+// last solution after which the error decreased, restored when the error spikes
+vector<double> goodSolution;
+double goodTimeTotal;
+double goodError;
+
+void resetControl() {
+	initialCfl = input.cfl;
+	failedCfl = 0;
+	lastError = numeric_limits<double>::infinity();
+	bestError = numeric_limits<double>::infinity();
+	bestIteration = currentIter;
+	decreasing = 0;
+	goodSolution.clear();
+	goodError = numeric_limits<double>::infinity();
+}
+
+// scales the global and local time steps to the new CFL
+void setCfl(double cfl) {
+	const auto factor = cfl / input.cfl;
+	timeStep *= factor;
+	for (auto &step : nodeTimeStep)
+		step *= factor;
+	input.cfl = cfl;
+}
+
+void saveGoodSolution(double error) {
+	goodSolution = computationData.uVertex;
+	goodTimeTotal = timeTotal;
+	goodError = error;
+}
+}
+
+// the geometry only depends on the mesh, so it is kept between runs and saved to the geometry cache
+void setupGeometry(const function<void(string)> &log) {
+	const auto hash = GeometryCache::meshHash();
+	if (hash == geometryHash) {
+		log("--> Reusing geometry");
+		return;
+	}
+	if (!input.geometryCache.empty() && GeometryCache::read(input.geometryCache, hash)) {
+		geometryHash = hash;
+		log("--> Geometry read from " + input.geometryCache);
+		return;
+	}
+
+	tetrahedraGeometry = TetrahedraGeometry(mesh.tetrahedra.size());
+	angleTotal = vector<double>(mesh.nodes.size());
+	nodeHeight = vector<double>(mesh.nodes.size(), numeric_limits<double>::infinity());
+	log("--> Computing geometry");
+	Geometry::computeGeometry();
+	geometryHash = hash;
+
+	if (input.geometryCache.empty())
+		return;
+	try {
+		GeometryCache::write(input.geometryCache, hash);
+	} catch (std::exception &e) {
+		log(string("Warning: ") + e.what());
+	}
+}
+
+// prepares the data for the iteration loop
+// the results are only initialized if the computation is not resumed
+void setup(const function<void(string)> &log) {
+	isosurfaceIndex.built = false;
+	Parallel::setThreads(input.threads);
+	if (!input.gather && Parallel::threads() > 1 && tetrahedraColors.empty()) {
+		log("--> Coloring tetrahedra for " + to_string(Parallel::threads()) + " threads");
+		Tetrahedra::computeColoring();
+	}
+
+	if (!input.resume) {
+		currentIter = 0;
+		timeTotal = 0;
+		timeStep = 0;
+		errorIter.clear();
+		computationData = ComputationData(mesh.nodes.size(), mesh.tetrahedra.size());
+	}
+	// reused when resuming in the same process, read from the cache when restarting from a checkpoint
+	setupGeometry(log);
+
+	log("--> Setting boundary conditions");
+	Nodes::setBoundaryConditions();
+
+	if (anisotropic) {
+		log("--> Computing anisotropic matrix");
+		Anisotropic::computeMatrix();
+	}
+
+	log("--> Getting max recession");
+	maxRecession = Nodes::getMaxRecession();
+
+	if (!input.resume && input.fastMarching) {
+		log("--> Initializing with fast marching");
+		Eikonal::fastMarching();
+	}
+
+	sweepColors.clear();
+	if (input.sweep && input.implicit) {
+		log("--> Gauss-Seidel sweep ignored, it does not combine with implicit");
+	} else if (input.sweep) {
+		log("--> Ordering the Gauss-Seidel sweep along the burn");
+		Nodes::computeSweepColors();
+		log("--> Sweep colors: " + to_string(sweepColors.size()));
+	}
+
+	resetControl();
+	ActiveSet::reset();
+	if (input.activeThreshold > 0 && (input.implicit || !input.fused || !input.gather || !sweepColors.empty()))
+		log("--> Active set ignored, it needs the fused node sweep without implicit or Gauss-Seidel");
+
+	// the local time steps are computed again with the CFL of the checkpoint, but its time step is kept as saved
+	const auto restoredTimeStep = timeStep;
+	log("--> Starting time step");
+	timeStep = maxHeight * input.cfl / (maxRecession);
+	nodeTimeStep.clear();
+	if (input.localTimeStep) {
+		log("--> Computing local time steps");
+		Nodes::computeLocalTimeStep();
+	}
+	if (input.restart)
+		timeStep = restoredTimeStep;
+
+	if (input.implicit) {
+		log("--> Preparing the implicit solver");
+		Implicit::setup();
+	}
+
+	if (currentIter < input.targetIter)
+		errorIter.resize(input.targetIter);
+}
+
+// fluxes of the current solution without updating it, after the mean gradient
+void computeFlux() {
+	if (input.gather)
+		Nodes::computeVertexGradient();
+	else
+		Tetrahedra::computeVertexGradient();
+	Nodes::applySymmetry();
+	Tetrahedra::computeDiffusiveContribution();
+	if (input.gather)
+		Nodes::computeDiffusiveFlux();
+	else
+		Tetrahedra::computeDiffusiveFlux();
+	if (anisotropic)
+		Anisotropic::computeRecession();
+	Nodes::computeHamitonianFlux();
+}
+
+// performs a single iteration and returns the error
+double iterate() {
+	isosurfaceIndex.built = false;
+	if (input.implicit)
+		return Implicit::iterate();
+	if (input.activeThreshold > 0 && input.fused && input.gather && sweepColors.empty())
+		return ActiveSet::iterate();
+	if (!sweepColors.empty())
+		return Nodes::computeSweep();
+
+	Tetrahedra::computeMeanGradient();
+	if (input.fused && input.gather)
+		return Nodes::computeFused();
+	computeFlux();
+	Nodes::computeResults();
+	return Nodes::getError();
+}
+
+Status control(double error, const function<void(string)> &log) {
+	const auto diverged = !isfinite(error) || error > 1;
+	if (input.adaptiveCfl && (diverged || error > goodError * spikeFactor)) {
+		if (goodSolution.empty())
+			return DIVERGED;
+		computationData.uVertex = goodSolution;
+		ActiveSet::reset();
+		Implicit::reset();
+		timeTotal = goodTimeTotal;
+		failedCfl = input.cfl;
+		setCfl(input.cfl * backoffFactor);
+		lastError = goodError;
+		decreasing = 0;
+		log("--> Error spike at iteration " + to_string(currentIter + 1) + ", rolling back with CFL " + to_string(input.cfl));
+		if (input.cfl < initialCfl * 1e-3)
+			return DIVERGED;
+		return RUNNING;
+	} else if (diverged) {
+		return DIVERGED;
+	} else if (input.adaptiveCfl) {
+		if (goodSolution.empty())
+			saveGoodSolution(error);
+		decreasing = error < lastError ? decreasing + 1 : 0;
+		// the CFL grows after a monotonic decrease, staying below the last one that failed
+		if (decreasing > 0 && decreasing % growthIterations == 0) {
+			saveGoodSolution(error);
+			auto cfl = input.cfl * growthFactor;
+			if (failedCfl > 0)
+				cfl = min(cfl, failedCfl * 0.9);
+			if (cfl > input.cfl)
+				setCfl(cfl);
+		}
+	}
+	lastError = error;
+
+	if (error < input.tolerance)
+		return CONVERGED;
+	if (error < bestError * (1 - plateauImprovement)) {
+		bestError = error;
+		bestIteration = currentIter;
+	}
+	if (input.plateau > 0 && currentIter - bestIteration >= input.plateau)
+		return STALLED;
+	return RUNNING;
+}
+}
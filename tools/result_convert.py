@@ -1,13 +1,15 @@
 import sys
 import json
+import struct
 import meshio
 import numpy
 
 def print_help():
 	print('''
-Usage: python result_convert.py input_file output_file/extension
-	input_file: json file generated by burnback export
+Usage: python result_convert.py input_file output_file/extension [mesh_file]
+	input_file: json file generated by burnback export, or binary results (.bbr)
 	output_file: output file, will use the name of input file if only extension is given
+	mesh_file: json mesh of the binary results
 ''')
 
 filename = ''
@@ -27,16 +29,40 @@ if '.' not in output_name:
 		name = '.'.join(name[:-1])
 	output_name = name + '.' + output_name
 
+def read_binary_results(filename):
+	raw = open(filename, 'rb').read()
+	magic, version, iterations, nodes, tetrahedra, mesh_hash, time_step, time_total = struct.unpack('<8sIIQQQdd', raw[:56])
+	if magic != b'BB3DRSLT' or version != 1:
+		raise ValueError('Not a burnback binary results file')
+	values = numpy.frombuffer(raw, dtype='<f8', offset=56)
+	return nodes, {
+		'uVertex': values[:nodes],
+		'fluxes': [values[nodes:2 * nodes], values[2 * nodes:3 * nodes]],
+		'duVertex': values[3 * nodes:].reshape(tetrahedra, 3),
+		'timeStep': time_step,
+		'timeTotal': time_total,
+	}
+
 print('Reading file ' + filename)
 try:
-	data = json.load(open(filename))
-except:
-	print('Error reading file ' + filename)
+	if filename.endswith('.bbr'):
+		if len(sys.argv) < 4:
+			print_help()
+			exit()
+		nodes, results = read_binary_results(filename)
+		mesh = json.load(open(sys.argv[3]))['mesh']
+		if len(mesh['nodes']) != nodes:
+			raise ValueError('The mesh does not match the results')
+	else:
+		data = json.load(open(filename))
+		mesh = data['mesh']
+		results = data['burnbackResults']
+except Exception as error:
+	print('Error reading file ' + filename + ': ' + str(error))
+	exit(1)
 
 # convert to meshio
 print('Converting to meshio')
-mesh = data['mesh']
-results = data['burnbackResults']
 
 # correcting index
 print('Correcting index')